@@ -4,8 +4,10 @@
 #include "Kismet/GameplayStatics.h"
 #include "Mood/MoodGameMode.h"
 #include "Mood/MoodHealthComponent.h"
+#include "Mood/MoodHitboxComponent.h"
 #include "Mood/Player/MoodCharacter.h"
 #include "Mood/Weapons/MoodWeaponSlotComponent.h"
+#include "MoodPerceptionSubsystem.h"
 
 AMoodEnemyCharacter::AMoodEnemyCharacter() {
 	ActivationSphere = CreateDefaultSubobject<USphereComponent>("Activation Sphere");
@@ -13,6 +15,7 @@ AMoodEnemyCharacter::AMoodEnemyCharacter() {
 	
 
 	Health = CreateDefaultSubobject<UMoodHealthComponent>(TEXT("Health"));
+	Hitboxes = CreateDefaultSubobject<UMoodHitboxComponent>(TEXT("Hitboxes"));
 
 	WeaponSlot = CreateDefaultSubobject<UMoodWeaponSlotComponent>(TEXT("Weapon Slot"));
 }
@@ -20,11 +23,19 @@ AMoodEnemyCharacter::AMoodEnemyCharacter() {
 void AMoodEnemyCharacter::BeginPlay() {
 	Super::BeginPlay();
 	ActivationSphere->OnComponentBeginOverlap.AddUniqueDynamic(this, &AMoodEnemyCharacter::OnActivationOverlap);
-	Health->OnHurt.AddUniqueDynamic(this, &AMoodEnemyCharacter::LoseHealth);
+	Health->OnHurtNative.AddUObject(this, &AMoodEnemyCharacter::LoseHealth);
 
 	MoodGameMode = Cast<AMoodGameMode>(GetWorld()->GetAuthGameMode());
 }
 
+void AMoodEnemyCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason) {
+	if (auto* Perception = GetWorld()->GetSubsystem<UMoodPerceptionSubsystem>()) {
+		Perception->Unregister(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
 void AMoodEnemyCharacter::LoseHealth(int Amount, int NewHealth) {
 	MoodGameMode->ChangeMoodValue(Amount);
 	MoodGameMode->ResetDamageTime();
@@ -47,44 +58,35 @@ void AMoodEnemyCharacter::SetPlayer(AMoodCharacter* InPlayer) {
 	if (!InPlayer) { return; }
 	
 	Player = InPlayer;
+	bHasSeenPlayer = true;
 	// I assume beginplay runs BEFORE this. we'll see :shrug: -KIM
 	ActivationSphere->OnComponentBeginOverlap.RemoveAll(this);
+	if (auto* Perception = GetWorld()->GetSubsystem<UMoodPerceptionSubsystem>()) {
+		Perception->Register(this);
+	}
 	OnPlayerSeen.Broadcast(Player);
 }
 
 void AMoodEnemyCharacter::ScanForPlayer() {
-	if (CanSeePlayer()) {
-		GetWorldTimerManager().ClearTimer(PlayerScanTimer);
+	if (!bHasSeenPlayer && CanSeePlayer()) {
+		bHasSeenPlayer = true;
 		ActivationSphere->OnComponentBeginOverlap.RemoveAll(this);
 		OnPlayerSeen.Broadcast(Player);
 	}
 }
 
+void AMoodEnemyCharacter::OnSightChecked(bool bCanSee) {
+	bCanSeePlayer = bCanSee;
+	ScanForPlayer();
+}
+
 void AMoodEnemyCharacter::SetExecutionMaterial_Implementation()
 {
 
 }
 
 bool AMoodEnemyCharacter::CanSeePlayer() {
-	if (!Player) { return false; }
-
-	auto PlayerCenter = Player->GetActorLocation();
-	auto SelfEyes = GetActorLocation() + FVector::UnitZ() * 90.0f;
-
-	FCollisionQueryParams CollisionQueryParams{};
-	CollisionQueryParams.AddIgnoredActor(this);
-	
-	FHitResult OutHit{};
-	GetWorld()->LineTraceSingleByChannel(
-		OutHit, SelfEyes, PlayerCenter,
-		ECC_Visibility, CollisionQueryParams
-	);
-
-	if (!OutHit.IsValidBlockingHit()) { return false; }
-
-	auto HitActor = OutHit.GetActor();
-	if (!HitActor) { return false; }
-	return HitActor == Player;
+	return Player && bCanSeePlayer;
 }
 
 void AMoodEnemyCharacter::OnActivationOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor,
@@ -97,8 +99,8 @@ void AMoodEnemyCharacter::OnActivationOverlap(UPrimitiveComponent* OverlappedCom
 
 	Player = OtherAsPlayer;
 
-	GetWorldTimerManager().SetTimer(
-		PlayerScanTimer, this, &AMoodEnemyCharacter::ScanForPlayer,
-		0.1f, true, 0.0f
-	);
+	// Keeps checking after the player has been seen, so CanSeePlayer stays up to date
+	if (auto* Perception = GetWorld()->GetSubsystem<UMoodPerceptionSubsystem>()) {
+		Perception->Register(this);
+	}
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include "Components/SphereComponent.h"
 #include "GameFramework/Character.h"
+#include "Mood/MoodDamageable.h"
 #include "Mood/Player/MoodCharacter.h"
 #include "MoodEnemyCharacter.generated.h"
 
@@ -10,11 +11,12 @@ class UBehaviorTree;
 class UPawnSensingComponent;
 class UMoodWeaponSlotComponent;
 class UMoodHealthComponent;
+class UMoodHitboxComponent;
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnPlayerSeen, AMoodCharacter*, Player);
 
 UCLASS(Abstract)
-class AMoodEnemyCharacter : public ACharacter {
+class AMoodEnemyCharacter : public ACharacter, public IMoodDamageable {
 	GENERATED_BODY()
 
 public:
@@ -25,13 +27,17 @@ public:
 
 	UFUNCTION(BlueprintCallable)
 	UMoodHealthComponent* GetHealth() { return Health; }
+	virtual UMoodHealthComponent* GetHealthComponent() const override { return Health; }
+	virtual UMoodHitboxComponent* GetHitboxComponent() const override { return Hitboxes; }
 	UFUNCTION(BlueprintCallable)
 	UMoodWeaponSlotComponent* GetWeaponSlot() { return WeaponSlot; }
 	UFUNCTION()
 	void SetPlayer(AMoodCharacter* InPlayer);
 	
+	// The result of the latest check by the perception subsystem, no trace is made here
 	UFUNCTION(BlueprintCallable)
 	bool CanSeePlayer();
+	FVector GetEyesLocation() const { return GetActorLocation() + FVector::UnitZ() * 90.0f; }
 	
 	UFUNCTION()
 	void LoseHealth(int Amount, int NewHealth);
@@ -45,6 +51,8 @@ protected:
 	TObjectPtr<UMoodWeaponSlotComponent> WeaponSlot = nullptr;
 	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite)
 	TObjectPtr<USphereComponent> ActivationSphere = nullptr;
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite)
+	TObjectPtr<UMoodHitboxComponent> Hitboxes = nullptr;
 
 	UPROPERTY(EditDefaultsOnly, Category=Sound)
 	USoundBase* EnemyHitSound = nullptr;
@@ -53,7 +61,10 @@ protected:
 	void SetExecutionMaterial();
 
 private:
+	friend class UMoodPerceptionSubsystem;
+
 	void BeginPlay() override;
+	void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	
 	UFUNCTION()
 	void OnActivationOverlap(
@@ -67,9 +78,12 @@ private:
 	UPROPERTY()
 	TObjectPtr<AMoodCharacter> Player;
 
+	// Broadcasts OnPlayerSeen the first time the player can be seen
 	UFUNCTION(BlueprintCallable)
 	void ScanForPlayer();
-	FTimerHandle PlayerScanTimer;
+	void OnSightChecked(bool bCanSee);
+	bool bCanSeePlayer = false;
+	bool bHasSeenPlayer = false;
 
 
 };
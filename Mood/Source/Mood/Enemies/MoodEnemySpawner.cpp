@@ -4,6 +4,7 @@
 #include "Components/BillboardComponent.h"
 #include "Components/ArrowComponent.h"
 #include "Mood/MoodHealthComponent.h"
+#include "Mood/Telemetry/MoodTelemetrySubsystem.h"
 
 AMoodEnemySpawner::AMoodEnemySpawner() {
 	Root = CreateDefaultSubobject<USceneComponent>("Root");
@@ -39,9 +40,14 @@ void AMoodEnemySpawner::Spawn() {
 		auto Enemy = Cast<AMoodEnemyCharacter>(SpawnedActor);
 		Enemy->SpawnDefaultController();
 		Enemy->SetPlayer(Player);
-		Enemy->GetHealth()->OnDeath.AddUniqueDynamic(this, &AMoodEnemySpawner::OnEnemyDeath);
+		Enemy->GetHealth()->OnDeathNative.AddUObject(this, &AMoodEnemySpawner::OnEnemyDeath);
 		SpawnedEnemies.Push(Enemy);
 	}
+
+	WaveCount++;
+	if (auto* Telemetry = UMoodTelemetrySubsystem::Get(this)) {
+		Telemetry->RecordSpawnerWave(this, WaveCount, EnemiesPerWave);
+	}
 }
 
 void AMoodEnemySpawner::OnEnemyDeath(AActor* DeadActor) {
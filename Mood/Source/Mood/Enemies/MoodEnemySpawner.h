@@ -33,6 +33,7 @@ private:
     float RespawnDelay = 30.0f;
     UPROPERTY(EditAnywhere, Category=Spawning)
     int EnemiesPerWave = 1;
+    int32 WaveCount = 0;
     UFUNCTION()
     void Spawn();
     UPROPERTY()
@@ -0,0 +1,99 @@
+#include "MoodPerceptionSubsystem.h"
+
+#include "MoodEnemyCharacter.h"
+#include "Engine/World.h"
+
+void UMoodPerceptionSubsystem::Initialize(FSubsystemCollectionBase& Collection) {
+	Super::Initialize(Collection);
+
+	TraceDelegate.BindUObject(this, &UMoodPerceptionSubsystem::OnTraceDone);
+}
+
+void UMoodPerceptionSubsystem::Register(AMoodEnemyCharacter* Enemy) {
+	if (!Enemy || Viewers.ContainsByPredicate([Enemy](const FViewer& Viewer) { return Viewer.Enemy == Enemy; })) {
+		return;
+	}
+
+	FViewer Viewer;
+	Viewer.Enemy = Enemy;
+	Viewers.Add(Viewer);
+}
+
+void UMoodPerceptionSubsystem::Unregister(AMoodEnemyCharacter* Enemy) {
+	// A trace still in flight finds no viewer when it's done and is dropped
+	Viewers.RemoveAllSwap([Enemy](const FViewer& Viewer) { return Viewer.Enemy == Enemy; });
+}
+
+void UMoodPerceptionSubsystem::Tick(float DeltaTime) {
+	Super::Tick(DeltaTime);
+
+	// Enemies destroyed without unregistering
+	Viewers.RemoveAllSwap([](const FViewer& Viewer) { return !Viewer.Enemy.IsValid(); });
+	RequestTraces();
+}
+
+TStatId UMoodPerceptionSubsystem::GetStatId() const {
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UMoodPerceptionSubsystem, STATGROUP_Tickables);
+}
+
+void UMoodPerceptionSubsystem::RequestTraces() {
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_MoodPerception_RequestTraces);
+
+	auto* World = GetWorld();
+	const auto Now = World->GetTimeSeconds();
+
+	// The time since the last check keeps growing, so even far away enemies off screen get their turn
+	Candidates.Reset();
+	for (auto i = 0; i < Viewers.Num(); i++) {
+		const auto& Viewer = Viewers[i];
+		const auto* Enemy = Viewer.Enemy.Get();
+		const auto Age = Now - Viewer.CheckedTime;
+		if (Viewer.PendingTrace.IsValid() || Age < MinCheckInterval || !Enemy->Player) {
+			continue;
+		}
+
+		const auto Distance = FVector::Dist(Enemy->GetActorLocation(), Enemy->Player->GetActorLocation());
+		auto Priority = static_cast<float>(Age * NearDistance / FMath::Max(Distance, NearDistance));
+		if (Enemy->WasRecentlyRendered()) {
+			Priority *= OnScreenWeight;
+		}
+		Candidates.Add({i, Priority});
+	}
+
+	if (Candidates.Num() > MaxTracesPerFrame) {
+		Candidates.Sort([](const FCandidate& A, const FCandidate& B) { return A.Priority > B.Priority; });
+		Candidates.SetNum(MaxTracesPerFrame, EAllowShrinking::No);
+	}
+
+	for (const auto& Candidate : Candidates) {
+		auto& Viewer = Viewers[Candidate.Viewer];
+		const auto* Enemy = Viewer.Enemy.Get();
+
+		FCollisionQueryParams CollisionQueryParams(SCENE_QUERY_STAT(MoodPerception));
+		CollisionQueryParams.AddIgnoredActor(Enemy);
+		Viewer.PendingTrace = World->AsyncLineTraceByChannel(
+			EAsyncTraceType::Single, Enemy->GetEyesLocation(), Enemy->Player->GetActorLocation(),
+			ECC_Visibility, CollisionQueryParams, FCollisionResponseParams::DefaultResponseParam, &TraceDelegate
+		);
+	}
+}
+
+void UMoodPerceptionSubsystem::OnTraceDone(const FTraceHandle& Handle, FTraceDatum& Datum) {
+	auto* Viewer = Viewers.FindByPredicate([&Handle](const FViewer& Viewer) { return Viewer.PendingTrace == Handle; });
+	if (!Viewer) {
+		return;
+	}
+
+	Viewer->PendingTrace = FTraceHandle();
+	Viewer->CheckedTime = GetWorld()->GetTimeSeconds();
+
+	auto* Enemy = Viewer->Enemy.Get();
+	if (!Enemy || !Enemy->Player) {
+		return;
+	}
+
+	const auto bCanSee = Datum.OutHits.Num() > 0 && Datum.OutHits[0].bBlockingHit
+		&& Datum.OutHits[0].GetActor() == Enemy->Player;
+	// Last, the enemy may react by unregistering
+	Enemy->OnSightChecked(bCanSee);
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "WorldCollision.h"
+#include "MoodPerceptionSubsystem.generated.h"
+
+class AMoodEnemyCharacter;
+
+/**
+ * Runs every enemy's line of sight check to the player. Each frame the enemies that have gone the longest
+ * without a check are traced, favoring ones close to the player or on screen, and no more than the trace
+ * budget. The traces are async, their results reach the enemies a frame later and are cached there, so
+ * the cost stays the same however many enemies there are.
+ */
+UCLASS()
+class UMoodPerceptionSubsystem : public UTickableWorldSubsystem {
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	// The enemy is checked until it unregisters, registering again does nothing
+	void Register(AMoodEnemyCharacter* Enemy);
+	void Unregister(AMoodEnemyCharacter* Enemy);
+
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override { return Viewers.Num() > 0; }
+	virtual TStatId GetStatId() const override;
+
+private:
+	static constexpr int32 MaxTracesPerFrame = 4;
+	// No enemy is checked more often than this, even when the budget would allow it
+	static constexpr double MinCheckInterval = 0.1;
+	// Enemies closer than this all count as close, farther ones wait longer in proportion to their distance
+	static constexpr double NearDistance = 1000.0;
+	static constexpr float OnScreenWeight = 4.f;
+
+	struct FViewer {
+		TWeakObjectPtr<AMoodEnemyCharacter> Enemy;
+		// World time of the last result
+		double CheckedTime = 0.0;
+		// Set while a trace is in flight, the enemy isn't checked again until it's back
+		FTraceHandle PendingTrace;
+	};
+	TArray<FViewer> Viewers;
+
+	struct FCandidate {
+		int32 Viewer = 0;
+		float Priority = 0.f;
+	};
+	TArray<FCandidate> Candidates;
+
+	FTraceDelegate TraceDelegate;
+
+	void RequestTraces();
+	void OnTraceDone(const FTraceHandle& Handle, FTraceDatum& Datum);
+};
@@ -0,0 +1,90 @@
+#include "MoodAttributeComponent.h"
+
+static_assert(Ema_Count <= 32, "DirtyAttributes has one bit per attribute");
+
+UMoodAttributeComponent::UMoodAttributeComponent() {
+	PrimaryComponentTick.bCanEverTick = false;
+	for (auto& Value : Values) {
+		Value = 1.f;
+	}
+}
+
+UMoodAttributeComponent* UMoodAttributeComponent::Get(const AActor* Actor) {
+	return Actor ? Actor->FindComponentByClass<UMoodAttributeComponent>() : nullptr;
+}
+
+void UMoodAttributeComponent::SetModifier(FName Source, EMoodAttribute Attribute, EMoodModifierOp Op, float Value) {
+	if (Attribute >= Ema_Count) {
+		UE_LOG(LogTemp, Error, TEXT("%s tried to modify an invalid attribute"), *Source.ToString());
+		return;
+	}
+
+	// Replaced modifiers go to the back, which is what makes the latest override win
+	auto& AttributeModifiers = Modifiers[Attribute];
+	const auto Index = AttributeModifiers.IndexOfByPredicate([Source](const FModifier& Modifier) {
+		return Modifier.Source == Source;
+	});
+	if (Index != INDEX_NONE) {
+		if (AttributeModifiers[Index].Op == Op && AttributeModifiers[Index].Value == Value) {
+			return;
+		}
+		AttributeModifiers.RemoveAt(Index);
+	}
+	AttributeModifiers.Add({Source, Op, Value});
+
+	DirtyAttributes |= 1u << Attribute;
+	RecomputeDirty();
+}
+
+void UMoodAttributeComponent::RemoveModifier(FName Source, EMoodAttribute Attribute) {
+	if (Attribute >= Ema_Count) {
+		return;
+	}
+
+	const auto Removed = Modifiers[Attribute].RemoveAll([Source](const FModifier& Modifier) {
+		return Modifier.Source == Source;
+	});
+	if (Removed > 0) {
+		DirtyAttributes |= 1u << Attribute;
+		RecomputeDirty();
+	}
+}
+
+void UMoodAttributeComponent::RemoveModifiers(FName Source) {
+	for (int32 Attribute = 0; Attribute < Ema_Count; Attribute++) {
+		const auto Removed = Modifiers[Attribute].RemoveAll([Source](const FModifier& Modifier) {
+			return Modifier.Source == Source;
+		});
+		if (Removed > 0) {
+			DirtyAttributes |= 1u << Attribute;
+		}
+	}
+	RecomputeDirty();
+}
+
+void UMoodAttributeComponent::RecomputeDirty() {
+	while (DirtyAttributes != 0) {
+		const auto Attribute = static_cast<EMoodAttribute>(FMath::CountTrailingZeros(DirtyAttributes));
+		DirtyAttributes &= DirtyAttributes - 1;
+
+		auto Add = 0.f;
+		auto Multiply = 1.f;
+		const FModifier* Override = nullptr;
+		for (const auto& Modifier : Modifiers[Attribute]) {
+			switch (Modifier.Op) {
+			case Emo_Add: Add += Modifier.Value; break;
+			case Emo_Multiply: Multiply *= Modifier.Value; break;
+			case Emo_Override: Override = &Modifier; break;
+			}
+		}
+
+		// Negative multipliers would turn movement and damage around
+		const auto NewValue = FMath::Max(0.f, Override ? Override->Value : (1.f + Add) * Multiply);
+		if (NewValue == Values[Attribute]) {
+			continue;
+		}
+
+		Values[Attribute] = NewValue;
+		OnAttributeChangedNative.Broadcast(Attribute, NewValue);
+	}
+}
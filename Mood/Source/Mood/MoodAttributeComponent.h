@@ -0,0 +1,70 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "MoodAttributeComponent.generated.h"
+
+// Every attribute is a multiplier, 1 when nothing modifies it
+UENUM(BlueprintType)
+enum EMoodAttribute {
+	Ema_MoveSpeed,
+	Ema_LookSpeed,
+	Ema_Damage,
+	Ema_HealthLoss,
+	Ema_FireDelay,
+	Ema_Count UMETA(Hidden)
+};
+
+// Adds are summed onto the base value and multiplies are applied to that sum. An override ignores all
+// of it, and among several overrides the latest one wins
+UENUM(BlueprintType)
+enum EMoodModifierOp {
+	Emo_Add,
+	Emo_Multiply,
+	Emo_Override
+};
+
+DECLARE_MULTICAST_DELEGATE_TwoParams(FOnAttributeChangedNative, EMoodAttribute /*Attribute*/, float /*NewValue*/);
+
+/**
+ * Final values of an actor's gameplay multipliers. Sources like the mood tier, slow motion or pickups set
+ * modifiers under their own name, and the affected attributes are recomputed only when a modifier changes,
+ * so reading one is a plain load.
+ */
+UCLASS(ClassGroup=(Custom), meta=(BlueprintSpawnableComponent))
+class UMoodAttributeComponent : public UActorComponent {
+	GENERATED_BODY()
+
+public:
+	UMoodAttributeComponent();
+
+	static UMoodAttributeComponent* Get(const AActor* Actor);
+
+	// Broadcast once per recompute for attributes whose final value changed
+	FOnAttributeChangedNative OnAttributeChangedNative;
+
+	UFUNCTION(BlueprintCallable, BlueprintPure)
+	float GetValue(EMoodAttribute Attribute) const { return Values[Attribute]; }
+
+	// A source has one modifier per attribute, setting it again replaces the old one
+	UFUNCTION(BlueprintCallable)
+	void SetModifier(FName Source, EMoodAttribute Attribute, EMoodModifierOp Op, float Value);
+	UFUNCTION(BlueprintCallable)
+	void RemoveModifier(FName Source, EMoodAttribute Attribute);
+	// Every modifier of the source, for when it ends
+	UFUNCTION(BlueprintCallable)
+	void RemoveModifiers(FName Source);
+
+private:
+	struct FModifier {
+		FName Source;
+		EMoodModifierOp Op = Emo_Multiply;
+		float Value = 1.f;
+	};
+	TArray<FModifier, TInlineAllocator<4>> Modifiers[Ema_Count];
+	float Values[Ema_Count];
+	// One bit per attribute whose modifiers changed since its value was computed
+	uint32 DirtyAttributes = 0;
+
+	void RecomputeDirty();
+};
@@ -0,0 +1,203 @@
+#include "MoodDamageSubsystem.h"
+
+#include "Engine/World.h"
+#include "MoodHealthComponent.h"
+#include "Mood/Simulation/MoodRules.h"
+
+UMoodDamageSubsystem* UMoodDamageSubsystem::Get(const UObject* WorldContextObject) {
+	const auto* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	return World ? World->GetSubsystem<UMoodDamageSubsystem>() : nullptr;
+}
+
+void UMoodDamageSubsystem::Initialize(FSubsystemCollectionBase& Collection) {
+	Super::Initialize(Collection);
+
+	PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &UMoodDamageSubsystem::OnWorldPostActorTick);
+}
+
+void UMoodDamageSubsystem::Deinitialize() {
+	FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickHandle);
+
+	Super::Deinitialize();
+}
+
+FMoodHealthHandle UMoodDamageSubsystem::Register(UMoodHealthComponent* Component, int32 InMaxHealth) {
+	FMoodHealthHandle Handle;
+	if (FreeRows.Num() > 0) {
+		Handle.Index = FreeRows.Pop(EAllowShrinking::No);
+	}
+	else {
+		Handle.Index = Health.AddDefaulted();
+		MaxHealth.AddDefaulted();
+		HealthLoss.AddDefaulted();
+		Dead.AddDefaulted();
+		Generations.AddZeroed();
+		Components.AddDefaulted();
+	}
+
+	const auto Index = Handle.Index;
+	Health[Index] = InMaxHealth;
+	MaxHealth[Index] = InMaxHealth;
+	HealthLoss[Index] = 1.f;
+	Dead[Index] = false;
+	Components[Index] = Component;
+	Handle.Generation = Generations[Index];
+	return Handle;
+}
+
+void UMoodDamageSubsystem::Unregister(FMoodHealthHandle& Handle) {
+	if (IsCurrent(Handle)) {
+		// Anything still queued for the row is dropped rather than hitting whoever gets it next
+		Generations[Handle.Index]++;
+		Components[Handle.Index] = nullptr;
+		FreeRows.Add(Handle.Index);
+	}
+	Handle = FMoodHealthHandle();
+}
+
+void UMoodDamageSubsystem::QueueHurt(const FMoodHealthHandle& Handle, int32 Amount, AActor* Attacker) {
+	if (!IsCurrent(Handle)) {
+		return;
+	}
+
+	auto& Event = Events.AddDefaulted_GetRef();
+	Event.Index = Handle.Index;
+	Event.Generation = Handle.Generation;
+	Event.Amount = Amount;
+	Event.Type = EHealthEvent::Hurt;
+	Event.Attacker = Attacker;
+}
+
+void UMoodDamageSubsystem::QueueHeal(const FMoodHealthHandle& Handle, int32 Amount) {
+	if (!IsCurrent(Handle)) {
+		return;
+	}
+
+	auto& Event = Events.AddDefaulted_GetRef();
+	Event.Index = Handle.Index;
+	Event.Generation = Handle.Generation;
+	Event.Amount = Amount;
+	Event.Type = EHealthEvent::Heal;
+}
+
+void UMoodDamageSubsystem::Revive(const FMoodHealthHandle& Handle) {
+	if (IsCurrent(Handle)) {
+		Health[Handle.Index] = MaxHealth[Handle.Index];
+		Dead[Handle.Index] = false;
+	}
+}
+
+void UMoodDamageSubsystem::SetHealthLoss(const FMoodHealthHandle& Handle, float HealthLossPercent) {
+	if (IsCurrent(Handle)) {
+		HealthLoss[Handle.Index] = HealthLossPercent;
+	}
+}
+
+int32 UMoodDamageSubsystem::GetHealth(const FMoodHealthHandle& Handle) const {
+	return IsCurrent(Handle) ? Health[Handle.Index] : 0;
+}
+
+bool UMoodDamageSubsystem::IsDead(const FMoodHealthHandle& Handle) const {
+	return IsCurrent(Handle) && Dead[Handle.Index];
+}
+
+void UMoodDamageSubsystem::Flush() {
+	if (Events.Num() == 0) {
+		return;
+	}
+
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_MoodDamage_Flush);
+
+	// Swapped out first, listeners can queue more for the next frame while this batch is dispatched
+	auto BatchEvents = MoveTemp(Events);
+	ResolveEvents(BatchEvents);
+	DispatchNotifications();
+
+	// Keep the allocation around for the next frame
+	if (Events.Num() == 0) {
+		BatchEvents.Reset();
+		Events = MoveTemp(BatchEvents);
+	}
+}
+
+bool UMoodDamageSubsystem::IsCurrent(const FMoodHealthHandle& Handle) const {
+	return Handle.IsValid() && Generations.IsValidIndex(Handle.Index) && Generations[Handle.Index] == Handle.Generation;
+}
+
+void UMoodDamageSubsystem::OnWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds) {
+	if (World != GetWorld())
+		return;
+
+	Flush();
+	OnFrameResolved.Broadcast();
+}
+
+void UMoodDamageSubsystem::ResolveEvents(TConstArrayView<FQueuedEvent> BatchEvents) {
+	Notifications.Reset();
+	for (const auto& Event : BatchEvents) {
+		const auto Index = Event.Index;
+		if (Generations[Index] != Event.Generation || Dead[Index]) {
+			continue;
+		}
+
+		auto& Notification = Notifications.AddDefaulted_GetRef();
+		Notification.Index = Index;
+		Notification.Generation = Event.Generation;
+		if (Event.Type == EHealthEvent::Heal) {
+			Notification.Type = ENotification::Heal;
+			Notification.Amount = FMath::Abs(Event.Amount);
+			Health[Index] = MoodRules::ComputeHealing(Notification.Amount, Health[Index], MaxHealth[Index]);
+			Notification.NewHealth = Health[Index];
+			continue;
+		}
+
+		Notification.Type = ENotification::Hurt;
+		Notification.Attacker = Event.Attacker;
+		Notification.Amount = MoodRules::ComputeHealthLoss(Event.Amount, HealthLoss[Index], Health[Index]);
+		Health[Index] -= Notification.Amount;
+		Notification.NewHealth = Health[Index];
+		Notification.bCanBeExecuted = MoodRules::CanBeExecuted(Health[Index], MaxHealth[Index]);
+
+		if (Health[Index] <= 0) {
+			Health[Index] = 0;
+			Dead[Index] = true;
+			auto& Death = Notifications.AddDefaulted_GetRef();
+			Death.Index = Index;
+			Death.Generation = Event.Generation;
+			Death.Type = ENotification::Death;
+		}
+	}
+}
+
+void UMoodDamageSubsystem::DispatchNotifications() {
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_MoodDamage_Dispatch);
+
+	// Moved out, a listener flushing again would otherwise reset the array being walked
+	auto BatchNotifications = MoveTemp(Notifications);
+	for (const auto& Notification : BatchNotifications) {
+		// A listener can destroy an actor, and with it a row, before the rest of the batch is out
+		auto* Component = Generations[Notification.Index] == Notification.Generation
+			? Components[Notification.Index].Get() : nullptr;
+		if (Component == nullptr) {
+			continue;
+		}
+
+		switch (Notification.Type) {
+		case ENotification::Hurt:
+			Component->NotifyHurt(Notification.Amount, Notification.NewHealth, Notification.Attacker.Get(),
+			                      Notification.bCanBeExecuted);
+			break;
+		case ENotification::Heal:
+			Component->NotifyHeal(Notification.Amount, Notification.NewHealth);
+			break;
+		case ENotification::Death:
+			Component->NotifyDeath();
+			break;
+		}
+	}
+
+	if (Notifications.Num() == 0) {
+		BatchNotifications.Reset();
+		Notifications = MoveTemp(BatchNotifications);
+	}
+}
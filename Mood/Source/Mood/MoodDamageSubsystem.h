@@ -0,0 +1,92 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "MoodDamageSubsystem.generated.h"
+
+class UMoodHealthComponent;
+
+DECLARE_MULTICAST_DELEGATE(FOnDamageFrameResolved);
+
+// Row of a health component in the damage subsystem's table, stale once the component unregisters
+struct FMoodHealthHandle {
+	int32 Index = INDEX_NONE;
+	int32 Generation = 0;
+
+	bool IsValid() const { return Index != INDEX_NONE; }
+};
+
+/**
+ * Owns the health of every health component as rows of plain arrays. Hurting and healing only queue an
+ * event, and all of a frame's events are resolved in one pass once the actors have ticked, in the order
+ * they were queued. Hurt, heal and death notifications go out after the pass, so listeners always see the
+ * health the frame ended with, and anything they queue in turn is resolved the next frame.
+ */
+UCLASS()
+class UMoodDamageSubsystem : public UWorldSubsystem {
+	GENERATED_BODY()
+
+public:
+	static UMoodDamageSubsystem* Get(const UObject* WorldContextObject);
+
+	// After every notification of the frame has gone out
+	FOnDamageFrameResolved OnFrameResolved;
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	FMoodHealthHandle Register(UMoodHealthComponent* Component, int32 MaxHealth);
+	void Unregister(FMoodHealthHandle& Handle);
+
+	void QueueHurt(const FMoodHealthHandle& Handle, int32 Amount, AActor* Attacker);
+	void QueueHeal(const FMoodHealthHandle& Handle, int32 Amount);
+	// Takes effect right away, anything still queued for the row is resolved against the new health
+	void Revive(const FMoodHealthHandle& Handle);
+	void SetHealthLoss(const FMoodHealthHandle& Handle, float HealthLossPercent);
+
+	// Health as of the last resolved frame
+	int32 GetHealth(const FMoodHealthHandle& Handle) const;
+	bool IsDead(const FMoodHealthHandle& Handle) const;
+
+	// Resolves everything queued so far without waiting for the end of the frame
+	void Flush();
+
+private:
+	enum class EHealthEvent : uint8 { Hurt, Heal };
+	struct FQueuedEvent {
+		int32 Index = INDEX_NONE;
+		int32 Generation = 0;
+		int32 Amount = 0;
+		EHealthEvent Type = EHealthEvent::Hurt;
+		TWeakObjectPtr<AActor> Attacker;
+	};
+
+	enum class ENotification : uint8 { Hurt, Heal, Death };
+	struct FNotification {
+		int32 Index = INDEX_NONE;
+		int32 Generation = 0;
+		int32 Amount = 0;
+		int32 NewHealth = 0;
+		ENotification Type = ENotification::Hurt;
+		bool bCanBeExecuted = false;
+		TWeakObjectPtr<AActor> Attacker;
+	};
+
+	// One row per registered component
+	TArray<int32> Health;
+	TArray<int32> MaxHealth;
+	TArray<float> HealthLoss;
+	TArray<bool> Dead;
+	TArray<int32> Generations;
+	TArray<TWeakObjectPtr<UMoodHealthComponent>> Components;
+	TArray<int32> FreeRows;
+
+	TArray<FQueuedEvent> Events;
+	TArray<FNotification> Notifications;
+	FDelegateHandle PostActorTickHandle;
+
+	bool IsCurrent(const FMoodHealthHandle& Handle) const;
+	void OnWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+	void ResolveEvents(TConstArrayView<FQueuedEvent> BatchEvents);
+	void DispatchNotifications();
+};
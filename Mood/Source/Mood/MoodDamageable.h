@@ -0,0 +1,27 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Interface.h"
+#include "MoodDamageable.generated.h"
+
+class UMoodHealthComponent;
+class UMoodHitboxComponent;
+
+UINTERFACE(MinimalAPI, meta=(CannotImplementInterfaceInBlueprint))
+class UMoodDamageable : public UInterface {
+	GENERATED_BODY()
+};
+
+/**
+ * Implemented by actors that own a health component, so hits can get to it and the hitboxes without
+ * searching through all of the actor's components. Use UMoodHealthComponent::Get and
+ * UMoodHitboxComponent::Get to look them up.
+ */
+class IMoodDamageable {
+	GENERATED_BODY()
+
+public:
+	virtual UMoodHealthComponent* GetHealthComponent() const = 0;
+	// Null for actors that take the same damage everywhere
+	virtual UMoodHitboxComponent* GetHitboxComponent() const { return nullptr; }
+};
@@ -0,0 +1,41 @@
+#include "MoodDeterminismSubsystem.h"
+
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "Misc/App.h"
+
+void UMoodDeterminismSubsystem::Initialize(FSubsystemCollectionBase& Collection) {
+	Super::Initialize(Collection);
+
+	bIsDeterministic = FParse::Value(FCommandLine::Get(), TEXT("MoodSeed="), SessionSeed);
+	if (!bIsDeterministic) {
+		SessionSeed = static_cast<int32>(FPlatformTime::Cycles());
+	}
+
+	float FixedStep = 0.f;
+	if (FParse::Value(FCommandLine::Get(), TEXT("MoodFixedStep="), FixedStep) && FixedStep > 0.f) {
+		FApp::SetUseFixedTimeStep(true);
+		FApp::SetFixedDeltaTime(FixedStep);
+	}
+
+	// Logged either way so any session can be replayed with -MoodSeed
+	UE_LOG(LogTemp, Log, TEXT("UMoodDeterminismSubsystem: Session seed %d, fixed step %s"), SessionSeed,
+		FApp::UseFixedTimeStep() ? *FString::SanitizeFloat(FApp::GetFixedDeltaTime()) : TEXT("off"));
+}
+
+FRandomStream UMoodDeterminismSubsystem::MakeStream(const UObject* Owner, const TCHAR* System) {
+	const auto* World = GEngine->GetWorldFromContextObject(Owner, EGetWorldErrorMode::ReturnNull);
+	const auto* GameInstance = World ? World->GetGameInstance() : nullptr;
+	const auto* Determinism = GameInstance ? GameInstance->GetSubsystem<UMoodDeterminismSubsystem>() : nullptr;
+	if (Determinism == nullptr) {
+		FRandomStream Stream;
+		Stream.GenerateNewSeed();
+		return Stream;
+	}
+
+	// Hashing names rather than FNames, FName indices change between runs
+	auto Seed = HashCombine(static_cast<uint32>(Determinism->SessionSeed), FCrc::StrCrc32(System));
+	Seed = HashCombine(Seed, FCrc::StrCrc32(*Owner->GetPathName()));
+	return FRandomStream(static_cast<int32>(Seed));
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "MoodDeterminismSubsystem.generated.h"
+
+/**
+ * Hands out the random streams gameplay code uses instead of the global RNG. Every stream is seeded
+ * from one session seed, so running with -MoodSeed=N repeats the same spread, sounds and animations
+ * for the same input. -MoodFixedStep=Seconds also locks the frame time to a fixed step.
+ */
+UCLASS()
+class UMoodDeterminismSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	// Stream for one system of one object, seeded from the session seed, the system and the owner's path
+	static FRandomStream MakeStream(const UObject* Owner, const TCHAR* System);
+
+	int32 GetSessionSeed() const { return SessionSeed; }
+	bool IsDeterministic() const { return bIsDeterministic; }
+
+private:
+	int32 SessionSeed = 0;
+	bool bIsDeterministic = false;
+};
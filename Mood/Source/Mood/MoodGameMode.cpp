@@ -2,8 +2,12 @@
 
 #include "MoodGameMode.h"
 
+#include "Engine/World.h"
 #include "Kismet/GameplayStatics.h"
 #include "Kismet/KismetMathLibrary.h"
+#include "MoodDamageSubsystem.h"
+#include "MoodTimeDilationSubsystem.h"
+#include "Mood/Telemetry/MoodTelemetrySubsystem.h"
 #include "UObject/ConstructorHelpers.h"
 
 AMoodGameMode::AMoodGameMode()
@@ -12,194 +16,264 @@ AMoodGameMode::AMoodGameMode()
 	static ConstructorHelpers::FClassFinder<APawn> PlayerPawnClassFinder(
 		TEXT("/Game/FirstPerson/Blueprints/BP_FirstPersonCharacter"));
 	DefaultPawnClass = PlayerPawnClassFinder.Class;
-	PrimaryActorTick.bCanEverTick = true;
+	// Mood decay and slow motion cooldowns are driven by timers and timestamps
+	PrimaryActorTick.bCanEverTick = false;
 }
 
-void AMoodGameMode::Tick(float DeltaTime) {
-	Super::Tick(DeltaTime);
+void AMoodGameMode::InitGame(const FString& MapName, const FString& Options, FString& ErrorMessage) {
+	Super::InitGame(MapName, Options, ErrorMessage);
 
-	DecreaseMoodOverTime();
-	TimeSinceSlowMotion();
+	if (MoodTierTable) {
+		return;
+	}
+
+	UE_LOG(LogTemp, Warning, TEXT("%s has no mood tier table, building one from its deprecated decay rates"), *GetName());
+	MoodTierTable = NewObject<UMoodTierTable>(this, TEXT("LegacyMoodTiers"));
+	bHasLegacyMoodTiers = true;
+	MoodTierTable->EditTiers(Ems_NoMood, [this](FMoodTier& Tier) { Tier.DecayRate = MoodDecayRate0_DEPRECATED; });
+	MoodTierTable->EditTiers(Ems_Mood222, [this](FMoodTier& Tier) { Tier.DecayRate = MoodDecayRate222_DEPRECATED; });
+	MoodTierTable->EditTiers(Ems_Mood444, [this](FMoodTier& Tier) { Tier.DecayRate = MoodDecayRate444_DEPRECATED; });
+	MoodTierTable->EditTiers(Ems_Mood666, [this](FMoodTier& Tier) { Tier.DecayRate = MoodDecayRate666_DEPRECATED; });
+}
+
+void AMoodGameMode::BeginPlay() {
+	Super::BeginPlay();
+
+	MoodMeterTimestamp = GetWorld()->GetTimeSeconds();
+	MoodDecayStartTime = MoodMeterTimestamp + TimeIdleBeforeMoodLoss;
+	SlowMotionReadyTimes.Init(0.0, GetMoodTierTable()->NumTiers());
+
+	PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &AMoodGameMode::OnWorldPostActorTick);
+	if (auto* Damage = UMoodDamageSubsystem::Get(this)) {
+		DamageResolvedHandle = Damage->OnFrameResolved.AddUObject(this, &AMoodGameMode::ApplyPendingMoodChanges);
+	}
+}
+
+void AMoodGameMode::EndPlay(const EEndPlayReason::Type EndPlayReason) {
+	FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickHandle);
+	if (auto* Damage = UMoodDamageSubsystem::Get(this)) {
+		Damage->OnFrameResolved.Remove(DamageResolvedHandle);
+	}
+
+	Super::EndPlay(EndPlayReason);
 }
 
 void AMoodGameMode::GameFinished() {
 	GameFinishedSig.Broadcast();
 }
 
+MoodRules::FMoodMeterRules AMoodGameMode::GetMoodMeterRules() const {
+	MoodRules::FMoodMeterRules Rules;
+	Rules.MoodLossWhenHit = MoodLossWhenHit;
+	Rules.MoodGainWhenDamaging = MoodGainWhenDamaging;
+	Rules.TimeIdleBeforeMoodLoss = TimeIdleBeforeMoodLoss;
+	Rules.TimeToKeepMood = TimeToKeepMood;
+	Rules.TimerSlowMotionReset = TimerSlowMotionReset;
+	Rules.SlowMotionTime = SlowMotionTime;
+	Rules.MaxMoodValue = GetMoodTierTable()->GetMaxMoodValue();
+	return Rules;
+}
+
 void AMoodGameMode::Respawn() {
 	PlayerRespawn.Broadcast();
 	ResetMoodValue();
 }
 
-EMoodState AMoodGameMode::GetMoodState() const {
-	if (MoodMeterValue >= 666) { return Ems_Mood666; }
-	if (MoodMeterValue >= 444) { return Ems_Mood444; }
-	if (MoodMeterValue >= 222) { return Ems_Mood222; }
-	return Ems_NoMood;
+float AMoodGameMode::GetMoodMeterValue() const {
+	return EvaluateMoodMeter(GetWorld()->GetTimeSeconds());
 }
 
 float AMoodGameMode::GetGibbingChance() {
-	auto T = 0.0f;
-	switch (GetMoodState()) {
-	case Ems_Mood666:
-		T = 1.0f;
-		break;
-	case Ems_Mood444:
-		T = 0.66f;
-		break;
-	case Ems_Mood222:
-		T = 0.33f;
-		break;
-	case Ems_NoMood:
-		T = 0.0f;
-		break;
-	}
-
-	return UKismetMathLibrary::Lerp(MinGibbingChance, MaxGibbingChance, T);
+	return UKismetMathLibrary::Lerp(MinGibbingChance, MaxGibbingChance, GetMoodTier().GibbingWeight);
 }
 
 void AMoodGameMode::ChangeMoodValue(int Value) {
-	auto previousMoodState = GetMoodState();
-
-	if ((MoodMeterValue + Value) > MoodMeterValue)
+	if (Value > 0)
 	{
-		OnEnemyHit.Broadcast();
+		PendingEnemyHits++;
 	}
 
 	if (Value < 0)
 	{
 		if (bIsChangingMood || !bCanLoseMood)
 			return;
-		Value *= MoodLossWhenHit;
-	}
-	
-	MoodMeterValue += Value * MoodGainWhenDamaging;
-	MoodMeterValue = FMath::Clamp(MoodMeterValue, 0, 1000);
-	
-	auto NewMoodState = GetMoodState();
-	if (NewMoodState != previousMoodState) {
-		OnMoodChanged.Broadcast(NewMoodState);
-		CheckSlowMotionValidity(previousMoodState, NewMoodState);
-		if (NewMoodState < previousMoodState)
-		{
-			bCanLoseMood = false;
-			GetWorldTimerManager().SetTimer(KeepMoodTimer, this, &AMoodGameMode::AllowMoodDecrease, TimeToKeepMood, false, TimeToKeepMood);
-		}
+		Value = MoodRules::ScaleMoodLoss(Value, MoodLossWhenHit);
 	}
+
+	PendingMoodDelta += Value;
+	bHasPendingMoodChange = true;
 }
 
 void AMoodGameMode::ResetMoodValue() {
 	MoodMeterValue = 0;
+	MoodMeterTimestamp = GetWorld()->GetTimeSeconds();
+	PendingMoodDelta = 0;
+	PendingEnemyHits = 0;
+	bHasPendingMoodChange = false;
+	// Resetting has never announced a mood change, listeners pick it up on the next one
+	CurrentMoodTier = 0;
+	ScheduleMoodDecay();
 }
 
 void AMoodGameMode::ResetDamageTime() {
-	TimeSinceEnemyDamaged = 0;
+	bHasPendingDamageReset = true;
 }
 
-void AMoodGameMode::AllowMoodDecrease()
-{
-	bCanLoseMood = true;
+void AMoodGameMode::OnWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds) {
+	if (World != GetWorld())
+		return;
+
+	ApplyPendingMoodChanges();
 }
 
-void AMoodGameMode::DecreaseMoodOverTime() {
-	if (bIsChangingMood)
+void AMoodGameMode::ApplyPendingMoodChanges() {
+	if (!bHasPendingMoodChange && !bHasPendingDamageReset)
 		return;
-	
-	auto PreviousMoodState = GetMoodState();
-	
-	TimeSinceEnemyDamaged += GetWorld()->DeltaTimeSeconds;
 
-	if (TimeSinceEnemyDamaged >= TimeIdleBeforeMoodLoss)
+	SettleMoodMeter();
+
+	if (bHasPendingDamageReset)
 	{
-		switch (PreviousMoodState)
-		{
-		case Ems_NoMood:
-			MoodDecayRate = MoodDecayRate0;
-			break;
-		case Ems_Mood222:
-			MoodDecayRate = MoodDecayRate222;
-			break;
-		case Ems_Mood444:
-			MoodDecayRate = MoodDecayRate444;
-			break;
-		case Ems_Mood666:
-			MoodDecayRate = MoodDecayRate666;
-			break;
-			default:
-				UE_LOG(LogTemp, Error, TEXT("AMoodGameMode::DecreaseMoodOverTime"))
-		}
-		MoodMeterValue -= GetWorld()->DeltaTimeSeconds * MoodDecayRate;
+		// The idle delay doesn't run while in slow motion, EndSlowMotion shifts it by the time spent there
+		const auto IdleFrom = bIsChangingMood ? SlowMotionStartTime : GetWorld()->GetTimeSeconds();
+		MoodDecayStartTime = IdleFrom + TimeIdleBeforeMoodLoss;
+		bHasPendingDamageReset = false;
 	}
 
-	MoodMeterValue = FMath::Clamp(MoodMeterValue, 0, 1000);
+	const auto Delta = PendingMoodDelta;
+	const auto EnemyHits = PendingEnemyHits;
+	PendingMoodDelta = 0;
+	PendingEnemyHits = 0;
+	bHasPendingMoodChange = false;
 
-	auto NewMoodState = GetMoodState();
-	if (PreviousMoodState != NewMoodState) {
-		OnMoodChanged.Broadcast(NewMoodState);
-		CheckSlowMotionValidity(PreviousMoodState, NewMoodState);
+	if (EnemyHits > 0)
+	{
+		OnEnemyHitNative.Broadcast(EnemyHits);
+		if (OnEnemyHit.IsBound())
+			OnEnemyHit.Broadcast(EnemyHits);
 	}
-}
 
-void AMoodGameMode::CheckSlowMotionValidity(EMoodState PreviousState, EMoodState NewMoodState)
-{
-	switch (NewMoodState)
+	if (Delta != 0)
 	{
-	case Ems_Mood666:
-		if (TimeLeftMood666 <= 0.f)
-		{
-			TriggerSlowMotion(NewMoodState);
-			TimeLeftMood666 = TimerSlowMotionReset;
-		}
-		break;
-	case Ems_Mood444:
-		if (PreviousState > NewMoodState && TimeLeftMood444 <= 0.f)
-		{
-			TriggerSlowMotion(NewMoodState);
-			TimeLeftMood444 = TimerSlowMotionReset;
-		}
-		break;
-	case Ems_Mood222:
-		if (PreviousState > NewMoodState && TimeLeftMood222 <= 0.f)
+		const auto PreviousMoodTier = CurrentMoodTier;
+		MoodMeterValue = MoodRules::AddMoodValue(MoodMeterValue, Delta, MoodGainWhenDamaging, GetMoodTierTable()->GetMaxMoodValue());
+
+		if (UpdateMoodState() && CurrentMoodTier > PreviousMoodTier)
 		{
-			TriggerSlowMotion(NewMoodState);
-			TimeLeftMood222 = TimerSlowMotionReset;
+			bCanLoseMood = false;
+			GetWorldTimerManager().SetTimer(KeepMoodTimer, this, &AMoodGameMode::AllowMoodDecrease, TimeToKeepMood, false, TimeToKeepMood);
 		}
-		TimeLeftMood666 = 0.f;
-		break;
-	case Ems_NoMood:
-		TimeLeftMood666 = 0.f;
-		TimeLeftMood444 = 0.f;
-		break;
-	default:
-		UE_LOG(LogTemp, Error, TEXT("MoodGameMode: No new mood state"));
 	}
+
+	ScheduleMoodDecay();
 }
 
-void AMoodGameMode::TimeSinceSlowMotion()
+void AMoodGameMode::AllowMoodDecrease()
 {
-	const auto DeltaTime = GetWorld()->DeltaTimeSeconds;
-	if (TimeLeftMood222 >= 0.f)
-		TimeLeftMood222 -= DeltaTime;
-	if (TimeLeftMood444 >= 0.f)
-		TimeLeftMood444 -= DeltaTime;
-	if (TimeLeftMood666 >= 0.f)
-		TimeLeftMood666 -= DeltaTime;
+	bCanLoseMood = true;
 }
 
-void AMoodGameMode::TriggerSlowMotion(EMoodState NewMoodState)
+float AMoodGameMode::EvaluateMoodMeter(const double Time) const {
+	if (bIsChangingMood)
+		return MoodMeterValue;
+
+	const auto* TierTable = GetMoodTierTable();
+	const auto Elapsed = static_cast<float>(Time - FMath::Max(MoodMeterTimestamp, MoodDecayStartTime));
+	return MoodRules::DecayMoodMeter(TierTable->GetTiers(), MoodMeterValue, TierTable->GetTierIndex(MoodMeterValue),
+		Elapsed, TierTable->GetMaxMoodValue());
+}
+
+void AMoodGameMode::SettleMoodMeter() {
+	const auto Now = GetWorld()->GetTimeSeconds();
+	MoodMeterValue = EvaluateMoodMeter(Now);
+	MoodMeterTimestamp = Now;
+	UpdateMoodState();
+}
+
+bool AMoodGameMode::UpdateMoodState() {
+	const auto PreviousMoodTier = CurrentMoodTier;
+	const auto NewMoodTier = GetMoodTierTable()->GetTierIndex(MoodMeterValue);
+	if (NewMoodTier == PreviousMoodTier)
+		return false;
+
+	CurrentMoodTier = NewMoodTier;
+	if (auto* Telemetry = UMoodTelemetrySubsystem::Get(this))
+		Telemetry->RecordMoodTierChanged(PreviousMoodTier, NewMoodTier);
+	const auto NewState = GetMoodTierTable()->GetTier(NewMoodTier).State;
+	OnMoodChangedNative.Broadcast(NewState);
+	if (OnMoodChanged.IsBound())
+		OnMoodChanged.Broadcast(NewState);
+	CheckSlowMotionValidity(PreviousMoodTier, NewMoodTier);
+	return true;
+}
+
+void AMoodGameMode::ScheduleMoodDecay() {
+	auto& TimerManager = GetWorldTimerManager();
+	TimerManager.ClearTimer(MoodDecayTimer);
+
+	if (bIsChangingMood || MoodMeterValue <= 0.f)
+		return;
+
+	const auto& Tier = GetMoodTierTable()->GetTier(CurrentMoodTier);
+	if (Tier.DecayRate <= 0.f)
+		return;
+
+	// Wake up once the meter reaches the threshold of the current tier, or zero
+	const auto Now = GetWorld()->GetTimeSeconds();
+	const auto IdleTimeLeft = static_cast<float>(FMath::Max(MoodDecayStartTime - Now, 0.0));
+	const auto TimeToThreshold = (MoodMeterValue - Tier.Threshold) / Tier.DecayRate;
+	const auto Delay = FMath::Max(IdleTimeLeft + TimeToThreshold, UE_KINDA_SMALL_NUMBER);
+	TimerManager.SetTimer(MoodDecayTimer, this, &AMoodGameMode::OnMoodDecayTimer, Delay, false);
+}
+
+void AMoodGameMode::OnMoodDecayTimer() {
+	SettleMoodMeter();
+	ScheduleMoodDecay();
+}
+
+void AMoodGameMode::CheckSlowMotionValidity(int32 PreviousTier, int32 NewTier)
+{
+	const auto* TierTable = GetMoodTierTable();
+	if (!SlowMotionReadyTimes.IsValidIndex(NewTier))
+	{
+		UE_LOG(LogTemp, Error, TEXT("MoodGameMode: No slow motion cooldown for tier %d"), NewTier);
+		return;
+	}
+
+	const auto Now = GetWorld()->GetTimeSeconds();
+	if (MoodRules::ShouldTriggerSlowMotion(TierTable->GetTier(NewTier), PreviousTier, NewTier, Now, SlowMotionReadyTimes[NewTier]))
+	{
+		TriggerSlowMotion(NewTier);
+		SlowMotionReadyTimes[NewTier] = Now + TimerSlowMotionReset;
+	}
+
+	MoodRules::ResetSlowMotionCooldowns(TierTable->GetTiers(), SlowMotionReadyTimes, NewTier);
+}
+
+void AMoodGameMode::TriggerSlowMotion(int32 NewTier)
 {
 	if (bCanLoseMood)
 		bCanLoseMood = false;
 
 	bIsChangingMood = true;
-	OnSlowMotionTriggered.Broadcast(NewMoodState);
-	UGameplayStatics::SetGlobalTimeDilation(GetWorld(), MoodChangeTimeDilation);
+	SlowMotionStartTime = GetWorld()->GetTimeSeconds();
+	GetWorldTimerManager().ClearTimer(MoodDecayTimer);
+	if (auto* Telemetry = UMoodTelemetrySubsystem::Get(this))
+		Telemetry->RecordSlowMotionTriggered(NewTier);
+	OnSlowMotionTriggered.Broadcast(GetMoodTierTable()->GetTier(NewTier).State);
+	GetWorld()->GetSubsystem<UMoodTimeDilationSubsystem>()->PushRequest(this, MoodChangeTimeDilation, Etd_SlowMotion);
 	GetWorldTimerManager().SetTimer(TimerSlowMotion, this, &AMoodGameMode::EndSlowMotion, SlowMotionTime, false, SlowMotionTime);
 }
 
 void AMoodGameMode::EndSlowMotion()
 {
+	// The meter and the idle delay were frozen during slow motion
+	const auto Now = GetWorld()->GetTimeSeconds();
+	MoodMeterTimestamp = Now;
+	MoodDecayStartTime += Now - SlowMotionStartTime;
+
 	bIsChangingMood = false;
-	UGameplayStatics::SetGlobalTimeDilation(GetWorld(), 1);
+	GetWorld()->GetSubsystem<UMoodTimeDilationSubsystem>()->PopRequest(this);
 	OnSlowMotionEnded.Broadcast();
+	ScheduleMoodDecay();
 }
\ No newline at end of file
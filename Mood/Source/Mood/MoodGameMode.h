@@ -4,23 +4,18 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/GameModeBase.h"
+#include "MoodTierTable.h"
+#include "Mood/Simulation/MoodRules.h"
 #include "MoodGameMode.generated.h"
 
-UENUM(BlueprintType)
-enum EMoodState
-{
-	Ems_Mood666,
-	Ems_Mood444,
-	Ems_Mood222,
-	Ems_NoMood
-};
-
 DECLARE_DYNAMIC_MULTICAST_DELEGATE(FGameFinished);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE(FPlayerRespawn);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnMoodChanged, EMoodState, NewState);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnSlowMotionTriggered, EMoodState, MoodState);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnSlowMotionEnded);
-DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnEnemyHit);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnEnemyHit, int32, HitCount);
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnMoodChangedNative, EMoodState /*NewState*/);
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnEnemyHitNative, int32 /*HitCount*/);
 
 UCLASS(minimalapi)
 class AMoodGameMode : public AGameModeBase
@@ -28,7 +23,9 @@ class AMoodGameMode : public AGameModeBase
 	GENERATED_BODY()
 
 protected:
-	virtual void Tick(float DeltaTime) override;
+	virtual void InitGame(const FString& MapName, const FString& Options, FString& ErrorMessage) override;
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 public:
 	AMoodGameMode();
@@ -47,6 +44,8 @@ public:
 	
 	UPROPERTY(BlueprintAssignable)
 	FOnMoodChanged OnMoodChanged;
+	// C++ listeners bind to the native events, the dynamic ones are only broadcast when Blueprints listen
+	FOnMoodChangedNative OnMoodChangedNative;
 
 	UPROPERTY(BlueprintAssignable)
 	FOnSlowMotionTriggered OnSlowMotionTriggered;
@@ -54,13 +53,25 @@ public:
 	FOnSlowMotionEnded OnSlowMotionEnded;
 	UPROPERTY(BlueprintAssignable)
 	FOnEnemyHit OnEnemyHit;
-
-	float GetMoodMeterValue() const { return MoodMeterValue; }
-	EMoodState GetMoodState() const;
+	FOnEnemyHitNative OnEnemyHitNative;
+
+	float GetMoodMeterValue() const;
+	EMoodState GetMoodState() const { return GetMoodTier().State; }
+	int32 GetMoodTierIndex() const { return GetMoodTierTable()->GetTierIndex(GetMoodMeterValue()); }
+	const FMoodTier& GetMoodTier() const { return GetMoodTierTable()->GetTier(GetMoodTierIndex()); }
+	const UMoodTierTable* GetMoodTierTable() const {
+		return MoodTierTable ? MoodTierTable.Get() : GetDefault<UMoodTierTable>();
+	}
+	// The table built from the deprecated properties when none is assigned, null when one is
+	UMoodTierTable* GetLegacyMoodTierTable() const { return bHasLegacyMoodTiers ? MoodTierTable.Get() : nullptr; }
 
 	UFUNCTION(BlueprintCallable, BlueprintPure)
 	float GetGibbingChance();
 
+	// The tuning values of the mood meter, for running the rules outside of a world
+	MoodRules::FMoodMeterRules GetMoodMeterRules() const;
+
+	// Mood changes are collected during the frame and applied once at the end of it
 	void ChangeMoodValue(int Value);
 	void ResetMoodValue();
 	void ResetDamageTime();
@@ -71,8 +82,23 @@ private:
 	UPROPERTY(EditDefaultsOnly, Category=Gibbing)
 	float MaxGibbingChance = 1.0f;
 	
+	// The meter is only written when something happens, decay in between is evaluated from the timestamp
 	float MoodMeterValue = 0.f;
-	float TimeSinceEnemyDamaged = 0.f;
+	double MoodMeterTimestamp = 0.0;
+	// World time when the idle delay has run out and the meter starts to decay
+	double MoodDecayStartTime = 0.0;
+	int32 CurrentMoodTier = 0;
+
+	// Accumulated by ChangeMoodValue and ResetDamageTime until the end of the frame
+	int32 PendingMoodDelta = 0;
+	int32 PendingEnemyHits = 0;
+	bool bHasPendingMoodChange = false;
+	bool bHasPendingDamageReset = false;
+	FDelegateHandle PostActorTickHandle;
+	// Hits are resolved after the actors tick too, this makes sure their mood changes land in the same frame
+	FDelegateHandle DamageResolvedHandle;
+	void OnWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+	void ApplyPendingMoodChanges();
 
 	UPROPERTY(EditDefaultsOnly, Category=MoodValues)
 	float MoodLossWhenHit = 1.f;
@@ -80,15 +106,21 @@ private:
 	float MoodGainWhenDamaging = 5.f;
 	UPROPERTY(EditDefaultsOnly, Category=MoodValues)
 	float TimeIdleBeforeMoodLoss = 2.f;
+	// Thresholds, decay rates and effects of every tier. Without one, the default tiers are used with the
+	// decay rates below and the HUD widget's tints
 	UPROPERTY(EditDefaultsOnly, Category=MoodValues)
-	float MoodDecayRate0 = 0.5f;
-	UPROPERTY(EditDefaultsOnly, Category=MoodValues)
-	float MoodDecayRate222 = 1.f;
-	UPROPERTY(EditDefaultsOnly, Category=MoodValues)
-	float MoodDecayRate444 = 2.f;
-	UPROPERTY(EditDefaultsOnly, Category=MoodValues)
-	float MoodDecayRate666 = 3.f;
-	float MoodDecayRate = 1.f;
+	TObjectPtr<UMoodTierTable> MoodTierTable = nullptr;
+	bool bHasLegacyMoodTiers = false;
+
+	// Authored before the tier table, move them to a table asset
+	UPROPERTY()
+	float MoodDecayRate0_DEPRECATED = 0.5f;
+	UPROPERTY()
+	float MoodDecayRate222_DEPRECATED = 1.f;
+	UPROPERTY()
+	float MoodDecayRate444_DEPRECATED = 2.f;
+	UPROPERTY()
+	float MoodDecayRate666_DEPRECATED = 3.f;
 
 	// Slow motion
 	UPROPERTY(EditDefaultsOnly, Category=SlowMotion)
@@ -97,14 +129,11 @@ private:
 	float MoodChangeTimeDilation = 0.05f;
 	UPROPERTY(EditDefaultsOnly, Category=SlowMotion)
 	float SlowMotionTime = 1.f;
-	float TimeInSlowMotion = 0.f;
+	double SlowMotionStartTime = 0.0;
 
-	float TimeLeftMood666 = 0.f;
-	float TimeLeftMood444 = 0.f;
-	float TimeLeftMood222 = 0.f;
+	// World time when each tier can trigger slow motion again
+	TArray<double> SlowMotionReadyTimes;
 	bool bIsChangingMood = false;
-	bool bHasReachedTimeDilationBottom = false;
-	float CurrentTimeDilation = 1.f;
 
 	FTimerHandle KeepMoodTimer;
 	bool bCanLoseMood = true;
@@ -113,11 +142,17 @@ private:
 	UPROPERTY(EditDefaultsOnly)
 	float TimeToKeepMood = 3.f;
 	
-	void DecreaseMoodOverTime();
+	float EvaluateMoodMeter(double Time) const;
+	void SettleMoodMeter();
+	bool UpdateMoodState();
+
+	// Fires when the decaying meter crosses into the tier below or runs out
+	FTimerHandle MoodDecayTimer;
+	void ScheduleMoodDecay();
+	void OnMoodDecayTimer();
 
 	FTimerHandle TimerSlowMotion;
-	void CheckSlowMotionValidity(EMoodState PreviousState, EMoodState NewMoodState);
-	void TimeSinceSlowMotion();
-	void TriggerSlowMotion(EMoodState NewMoodState);
+	void CheckSlowMotionValidity(int32 PreviousTier, int32 NewTier);
+	void TriggerSlowMotion(int32 NewTier);
 	void EndSlowMotion();
 };
\ No newline at end of file
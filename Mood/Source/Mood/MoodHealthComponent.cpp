@@ -1,52 +1,88 @@
 ﻿#include "MoodHealthComponent.h"
-#include "Kismet/KismetMathLibrary.h"
+#include "MoodDamageable.h"
+#include "Mood/Telemetry/MoodTelemetrySubsystem.h"
 
-void UMoodHealthComponent::Hurt(int Amount) {
-	if (IsDead) { return; }
-	
-	Amount = abs(Amount) * HealthLossPercent;
-	Amount = UKismetMathLibrary::Clamp(Amount, 0, CurrentHealth);
-	
-	CurrentHealth -= Amount;
-	
-	OnHurt.Broadcast(Amount, CurrentHealth);
-
-	if (CurrentHealth < MaxHealth / 4) {
-		bCanBeExecuted = true;
+UMoodHealthComponent* UMoodHealthComponent::Get(const AActor* Actor) {
+	if (const auto* Damageable = Cast<IMoodDamageable>(Actor)) {
+		return Damageable->GetHealthComponent();
 	}
-	
-	if (CurrentHealth <= 0) {
-		CurrentHealth = 0;
-		IsDead = true;
-		OnDeath.Broadcast(GetOwner());
-		return;
+	return Actor ? Actor->FindComponentByClass<UMoodHealthComponent>() : nullptr;
+}
+
+float UMoodHealthComponent::HealthPercent() {
+	const auto* Damage = UMoodDamageSubsystem::Get(this);
+	return Damage ? static_cast<float>(Damage->GetHealth(Handle)) / MaxHealth : 0.f;
+}
+
+void UMoodHealthComponent::Hurt(int Amount, AActor* Attacker) {
+	if (auto* Damage = UMoodDamageSubsystem::Get(this)) {
+		Damage->QueueHurt(Handle, Amount, Attacker);
 	}
 }
 
 void UMoodHealthComponent::Heal(int Amount) {
-	if (IsDead) { return; }
+	if (auto* Damage = UMoodDamageSubsystem::Get(this)) {
+		Damage->QueueHeal(Handle, Amount);
+	}
+}
+
+void UMoodHealthComponent::Reset() {
+	if (auto* Damage = UMoodDamageSubsystem::Get(this)) {
+		Damage->Revive(Handle);
+	}
+}
+
+void UMoodHealthComponent::NotifyHurt(int32 Amount, int32 NewHealth, AActor* Attacker, bool bNowExecutable) {
+	if (auto* Telemetry = UMoodTelemetrySubsystem::Get(this)) {
+		Telemetry->RecordHurt(Attacker, GetOwner(), Amount, NewHealth);
+	}
 	
-	Amount = abs(Amount);
-	CurrentHealth += Amount;
-	if (CurrentHealth > MaxHealth) {
-		CurrentHealth = MaxHealth;
+	OnHurtNative.Broadcast(Amount, NewHealth);
+	if (OnHurt.IsBound()) {
+		OnHurt.Broadcast(Amount, NewHealth);
 	}
 
+	if (bNowExecutable) {
+		bCanBeExecuted = true;
+	}
+}
+
+void UMoodHealthComponent::NotifyHeal(int32 Amount, int32 NewHealth) {
 	//todo! technically doesnt send the actual health gain if it gets clamped
-	OnHeal.Broadcast(Amount, CurrentHealth);
+	OnHeal.Broadcast(Amount, NewHealth);
 }
 
-void UMoodHealthComponent::Reset() {
-	IsDead = false;
-	CurrentHealth = MaxHealth;
+void UMoodHealthComponent::NotifyDeath() {
+	OnDeathNative.Broadcast(GetOwner());
+	if (OnDeath.IsBound()) {
+		OnDeath.Broadcast(GetOwner());
+	}
+}
+
+MoodRules::FHealthRules UMoodHealthComponent::GetHealthRules() const {
+	MoodRules::FHealthRules Rules;
+	Rules.MaxHealth = MaxHealth;
+	return Rules;
 }
 
 void UMoodHealthComponent::AlterHealthLoss(float Value) {
-	HealthLossPercent = Value;
+	if (auto* Damage = UMoodDamageSubsystem::Get(this)) {
+		Damage->SetHealthLoss(Handle, Value);
+	}
 }
 
 void UMoodHealthComponent::BeginPlay() {
 	Super::BeginPlay();
 	
-	CurrentHealth = MaxHealth;
+	if (auto* Damage = UMoodDamageSubsystem::Get(this)) {
+		Handle = Damage->Register(this, MaxHealth);
+	}
+}
+
+void UMoodHealthComponent::EndPlay(const EEndPlayReason::Type EndPlayReason) {
+	if (auto* Damage = UMoodDamageSubsystem::Get(this)) {
+		Damage->Unregister(Handle);
+	}
+
+	Super::EndPlay(EndPlayReason);
 }
@@ -1,17 +1,25 @@
 ﻿#pragma once
 
+#include "MoodDamageSubsystem.h"
+#include "Mood/Simulation/MoodRules.h"
 #include "MoodHealthComponent.generated.h"
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnHeal, int, Amount, int, NewHealth);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnHurt, int, Amount, int, NewHealth);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnDeath, AActor*, DeadActor);
+DECLARE_MULTICAST_DELEGATE_TwoParams(FOnHurtNative, int32 /*Amount*/, int32 /*NewHealth*/);
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnDeathNative, AActor* /*DeadActor*/);
 
 UCLASS(Blueprintable, BlueprintType, ClassGroup=(Custom), meta=(BlueprintSpawnableComponent))
 class UMoodHealthComponent : public UActorComponent {
 GENERATED_BODY()
 public:
+	// Straight from the actor when it's an IMoodDamageable, otherwise searched for among its components
+	static UMoodHealthComponent* Get(const AActor* Actor);
+
+	// Health as of the end of the last frame, hurting and healing only take effect once the frame is resolved
 	UFUNCTION(BlueprintCallable, BlueprintPure)
-	float HealthPercent() { return static_cast<float>(CurrentHealth) / MaxHealth;}
+	float HealthPercent();
 
 	UPROPERTY(BlueprintAssignable)
 	FOnDeath OnDeath;
@@ -19,25 +27,36 @@ public:
 	FOnHeal OnHeal;
 	UPROPERTY(BlueprintAssignable)
 	FOnHurt OnHurt;
+	// C++ listeners bind to these, the dynamic versions are only broadcast when Blueprints listen
+	FOnDeathNative OnDeathNative;
+	FOnHurtNative OnHurtNative;
 
+	// Queued with the damage subsystem, the delegates are broadcast when it resolves the frame
 	UFUNCTION(BlueprintCallable)
-	void Hurt(int Amount);
+	void Hurt(int Amount, AActor* Attacker = nullptr);
 	UFUNCTION(BlueprintCallable)
 	void Heal(int Amount);
 	UFUNCTION(BlueprintCallable)
 	void Reset();
 
 	void AlterHealthLoss(float Value);
+	MoodRules::FHealthRules GetHealthRules() const;
 
 	bool bCanBeExecuted = false;
 
 protected:
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	
 private:
+	friend class UMoodDamageSubsystem;
+
 	UPROPERTY(EditDefaultsOnly)
 	int MaxHealth = 100;
-	int CurrentHealth = 0;
-	float HealthLossPercent = 1.f;
-	bool IsDead = false;
+	// The health itself lives in the damage subsystem's table
+	FMoodHealthHandle Handle;
+
+	void NotifyHurt(int32 Amount, int32 NewHealth, AActor* Attacker, bool bNowExecutable);
+	void NotifyHeal(int32 Amount, int32 NewHealth);
+	void NotifyDeath();
 };
@@ -25,7 +25,7 @@ void AMoodHealthPickup::PickedUp(ACharacter* Character) {
     AMoodCharacter* MoodCharacter = Cast<AMoodCharacter>(Character);
     if (MoodCharacter) {
         // Get the health component of the character
-        UMoodHealthComponent* HealthComponent = MoodCharacter->FindComponentByClass<UMoodHealthComponent>();
+        UMoodHealthComponent* HealthComponent = MoodCharacter->GetHealthComponent();
         if (HealthComponent) {
             //Use the configurable HealAmount
             HealthComponent->Heal(HealAmount);
@@ -0,0 +1,99 @@
+#include "MoodHitboxComponent.h"
+
+#include "MoodDamageable.h"
+#include "Components/BoxComponent.h"
+#include "Components/CapsuleComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Components/SphereComponent.h"
+#include "GameFramework/Character.h"
+#include "PhysicsEngine/PhysicsAsset.h"
+#include "PhysicsEngine/SkeletalBodySetup.h"
+
+const FName UMoodHitboxComponent::ProxyProfile = TEXT("HitboxProxy");
+
+UMoodHitboxComponent* UMoodHitboxComponent::Get(const AActor* Actor) {
+	if (const auto* Damageable = Cast<IMoodDamageable>(Actor)) {
+		return Damageable->GetHitboxComponent();
+	}
+	return Actor ? Actor->FindComponentByClass<UMoodHitboxComponent>() : nullptr;
+}
+
+float UMoodHitboxComponent::GetDamageMultiplier(const UPrimitiveComponent* Proxy) const {
+	const auto* Found = Proxies.FindByPredicate([Proxy](const FMoodHitboxProxy& Other) { return Other.Shape == Proxy; });
+	return Found ? Found->DamageMultiplier : 1.f;
+}
+
+void UMoodHitboxComponent::BeginPlay() {
+	Super::BeginPlay();
+
+	const auto* Character = Cast<ACharacter>(GetOwner());
+	if (!Character || !Character->GetMesh() || !Character->GetMesh()->GetPhysicsAsset()) {
+		UE_LOG(LogTemp, Error, TEXT("%s has no physics asset to make hitboxes from"), *GetNameSafe(GetOwner()));
+		return;
+	}
+
+	CreateProxies(Character->GetMesh());
+	if (Proxies.Num() == 0) {
+		return;
+	}
+
+	// Weapon traces hit the proxies now, everything else of the owner is left out of them
+	TInlineComponentArray<UPrimitiveComponent*> Primitives(GetOwner());
+	for (auto* Primitive : Primitives) {
+		if (Primitive->GetCollisionProfileName() != ProxyProfile) {
+			Primitive->SetCollisionResponseToChannel(ECC_Hitscan, ECR_Ignore);
+		}
+	}
+}
+
+void UMoodHitboxComponent::CreateProxies(USkeletalMeshComponent* Mesh) {
+	auto* Owner = GetOwner();
+	for (const auto* Body : Mesh->GetPhysicsAsset()->SkeletalBodySetups) {
+		if (!Body || (ProxyBones.Num() > 0 && !ProxyBones.Contains(Body->BoneName))) {
+			continue;
+		}
+
+		// One simple shape per body is close enough for telling a head from a leg
+		const auto& Geometry = Body->AggGeom;
+		UShapeComponent* Shape = nullptr;
+		FTransform ShapeTransform;
+		if (Geometry.SphylElems.Num() > 0) {
+			const auto& Elem = Geometry.SphylElems[0];
+			auto* Capsule = NewObject<UCapsuleComponent>(Owner);
+			Capsule->InitCapsuleSize(Elem.Radius, Elem.Radius + Elem.Length * 0.5f);
+			ShapeTransform = Elem.GetTransform();
+			Shape = Capsule;
+		}
+		else if (Geometry.BoxElems.Num() > 0) {
+			const auto& Elem = Geometry.BoxElems[0];
+			auto* Box = NewObject<UBoxComponent>(Owner);
+			Box->InitBoxExtent(FVector(Elem.X, Elem.Y, Elem.Z) * 0.5);
+			ShapeTransform = Elem.GetTransform();
+			Shape = Box;
+		}
+		else if (Geometry.SphereElems.Num() > 0) {
+			const auto& Elem = Geometry.SphereElems[0];
+			auto* Sphere = NewObject<USphereComponent>(Owner);
+			Sphere->InitSphereRadius(Elem.Radius);
+			ShapeTransform = FTransform(Elem.Center);
+			Shape = Sphere;
+		}
+		else {
+			continue;
+		}
+
+		Shape->SetupAttachment(Mesh, Body->BoneName);
+		Shape->SetRelativeTransform(ShapeTransform);
+		Shape->SetCollisionProfileName(ProxyProfile);
+		Shape->SetGenerateOverlapEvents(false);
+		Shape->SetCanEverAffectNavigation(false);
+		Shape->RegisterComponent();
+
+		auto& Proxy = Proxies.AddDefaulted_GetRef();
+		Proxy.Shape = Shape;
+		Proxy.Bone = Body->BoneName;
+		if (const auto* Multiplier = BoneDamageMultipliers.Find(Body->BoneName)) {
+			Proxy.DamageMultiplier = *Multiplier;
+		}
+	}
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "MoodHitboxComponent.generated.h"
+
+// Weapon traces, set up as the Hitscan trace channel in DefaultEngine.ini
+#define ECC_Hitscan ECC_GameTraceChannel3
+
+class UShapeComponent;
+class USkeletalMeshComponent;
+
+USTRUCT()
+struct FMoodHitboxProxy {
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TObjectPtr<UShapeComponent> Shape = nullptr;
+	FName Bone;
+	float DamageMultiplier = 1.f;
+};
+
+/**
+ * Gives a character simple shapes for its body parts, made from the bodies of its mesh's physics asset.
+ * They are the only part of the character weapon traces hit, so a shot tests a few capsules instead of the
+ * character's mesh and triggers, and damage can depend on the part that was hit.
+ */
+UCLASS(ClassGroup=(Custom), meta=(BlueprintSpawnableComponent))
+class UMoodHitboxComponent : public UActorComponent {
+	GENERATED_BODY()
+
+public:
+	static const FName ProxyProfile;
+
+	// Straight from the actor when it's an IMoodDamageable, otherwise searched for among its components
+	static UMoodHitboxComponent* Get(const AActor* Actor);
+	// 1 for anything that isn't one of the proxies
+	float GetDamageMultiplier(const UPrimitiveComponent* Proxy) const;
+
+protected:
+	virtual void BeginPlay() override;
+
+private:
+	// Bones left out take normal damage
+	UPROPERTY(EditDefaultsOnly, Category=Hitbox)
+	TMap<FName, float> BoneDamageMultipliers;
+	// Only these bones get a proxy, every body of the physics asset does when it's empty
+	UPROPERTY(EditDefaultsOnly, Category=Hitbox)
+	TArray<FName> ProxyBones;
+
+	UPROPERTY()
+	TArray<FMoodHitboxProxy> Proxies;
+
+	void CreateProxies(USkeletalMeshComponent* Mesh);
+};
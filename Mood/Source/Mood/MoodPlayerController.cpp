@@ -4,6 +4,12 @@
 #include "MoodPlayerController.h"
 #include "EnhancedInputSubsystems.h"
 #include "Engine/LocalPlayer.h"
+#include "Player/MoodInputRecorderComponent.h"
+
+AMoodPlayerController::AMoodPlayerController()
+{
+	InputRecorder = CreateDefaultSubobject<UMoodInputRecorderComponent>(TEXT("InputRecorder"));
+}
 
 void AMoodPlayerController::BeginPlay()
 {
@@ -15,4 +21,11 @@ void AMoodPlayerController::BeginPlay()
 		// add the mapping context so we get controls
 		Subsystem->AddMappingContext(InputMappingContext, 0);
 	}
-}
\ No newline at end of file
+}
+
+void AMoodPlayerController::PostProcessInput(const float DeltaTime, const bool bGamePaused)
+{
+	Super::PostProcessInput(DeltaTime, bGamePaused);
+
+	InputRecorder->OnInputProcessed(bGamePaused);
+}
@@ -7,6 +7,7 @@
 #include "MoodPlayerController.generated.h"
 
 class UInputMappingContext;
+class UMoodInputRecorderComponent;
 
 /**
  *
@@ -15,17 +16,26 @@ UCLASS()
 class MOOD_API AMoodPlayerController : public APlayerController
 {
 	GENERATED_BODY()
-	
+
+public:
+	AMoodPlayerController();
+
 protected:
 
 	/** Input Mapping Context to be used for player input */
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Input)
 	UInputMappingContext* InputMappingContext;
 
+	/** Records or replays the character's input when asked to on the command line */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Input)
+	UMoodInputRecorderComponent* InputRecorder;
+
 	// Begin Actor interface
 protected:
 
 	virtual void BeginPlay() override;
 
 	// End Actor interface
+
+	virtual void PostProcessInput(const float DeltaTime, const bool bGamePaused) override;
 };
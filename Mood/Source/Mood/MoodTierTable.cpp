@@ -0,0 +1,97 @@
+#include "MoodTierTable.h"
+
+UMoodTierTable::UMoodTierTable() {
+	// The tiers the game shipped with. HUD tints were authored on the widget, a game mode without a table
+	// builds one from these and the deprecated game mode and widget properties
+	FMoodTier NoMood;
+	NoMood.Threshold = 0;
+	NoMood.State = Ems_NoMood;
+	NoMood.DecayRate = 0.5f;
+	Tiers.Add(NoMood);
+
+	FMoodTier Mood222;
+	Mood222.Threshold = 222;
+	Mood222.State = Ems_Mood222;
+	Mood222.DecayRate = 1.f;
+	Mood222.SpeedMultiplier = 1.1f;
+	Mood222.DamageMultiplier = 1.3f;
+	Mood222.GibbingWeight = 0.33f;
+	Mood222.bTriggersSlowMotion = true;
+	Tiers.Add(Mood222);
+
+	FMoodTier Mood444;
+	Mood444.Threshold = 444;
+	Mood444.State = Ems_Mood444;
+	Mood444.DecayRate = 2.f;
+	Mood444.SpeedMultiplier = 1.2f;
+	Mood444.DamageMultiplier = 1.6f;
+	Mood444.HealthLossMultiplier = 0.9f;
+	Mood444.GibbingWeight = 0.66f;
+	Mood444.bTriggersSlowMotion = true;
+	Tiers.Add(Mood444);
+
+	FMoodTier Mood666;
+	Mood666.Threshold = 666;
+	Mood666.State = Ems_Mood666;
+	Mood666.DecayRate = 3.f;
+	Mood666.SpeedMultiplier = 1.5f;
+	Mood666.DamageMultiplier = 2.f;
+	Mood666.HealthLossMultiplier = 0.9f;
+	Mood666.bRegeneratesHealth = true;
+	Mood666.GibbingWeight = 1.f;
+	Mood666.bTriggersSlowMotion = true;
+	Mood666.bSlowMotionOnlyWhenRising = false;
+	Tiers.Add(Mood666);
+}
+
+void UMoodTierTable::PostInitProperties() {
+	Super::PostInitProperties();
+
+	Bake();
+}
+
+void UMoodTierTable::PostLoad() {
+	Super::PostLoad();
+
+	Bake();
+}
+
+#if WITH_EDITOR
+void UMoodTierTable::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) {
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	Bake();
+}
+#endif
+
+void UMoodTierTable::EditTiers(EMoodState State, TFunctionRef<void(FMoodTier&)> Edit) {
+	for (auto& Tier : Tiers) {
+		if (Tier.State == State) {
+			Edit(Tier);
+		}
+	}
+	Bake();
+}
+
+void UMoodTierTable::Bake() {
+	BakedTiers = Tiers;
+	if (BakedTiers.Num() == 0) {
+		BakedTiers.AddDefaulted();
+	}
+	if (BakedTiers.Num() > MAX_uint8) {
+		UE_LOG(LogTemp, Error, TEXT("%s has more than %d mood tiers, the rest are ignored"), *GetName(), MAX_uint8);
+		BakedTiers.SetNum(MAX_uint8);
+	}
+
+	BakedTiers.StableSort([](const FMoodTier& A, const FMoodTier& B) { return A.Threshold < B.Threshold; });
+	BakedTiers[0].Threshold = 0;
+
+	TierLookup.SetNumUninitialized(MaxMoodValue + 1);
+	auto TierIndex = 0;
+	for (auto Value = 0; Value <= MaxMoodValue; Value++) {
+		while (TierIndex + 1 < BakedTiers.Num() && BakedTiers[TierIndex + 1].Threshold <= Value) {
+			TierIndex++;
+		}
+		TierLookup[Value] = static_cast<uint8>(TierIndex);
+	}
+}
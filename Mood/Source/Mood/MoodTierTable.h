@@ -0,0 +1,102 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "MoodTierTable.generated.h"
+
+UENUM(BlueprintType)
+enum EMoodState
+{
+	Ems_Mood666,
+	Ems_Mood444,
+	Ems_Mood222,
+	Ems_NoMood
+};
+
+USTRUCT(BlueprintType)
+struct FMoodTier
+{
+	GENERATED_BODY()
+
+	// Meter value where this tier begins
+	UPROPERTY(EditAnywhere, BlueprintReadOnly)
+	int32 Threshold = 0;
+	// State sent with OnMoodChanged and OnSlowMotionTriggered
+	UPROPERTY(EditAnywhere, BlueprintReadOnly)
+	TEnumAsByte<EMoodState> State = Ems_NoMood;
+
+	// Meter loss per second once the player has stopped dealing damage
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category=Decay)
+	float DecayRate = 0.5f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category=Player)
+	float SpeedMultiplier = 1.f;
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category=Player)
+	float DamageMultiplier = 1.f;
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category=Player)
+	float HealthLossMultiplier = 1.f;
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category=Player)
+	bool bRegeneratesHealth = false;
+
+	// Where between the game mode's min and max gibbing chance this tier sits
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category=Gibbing, meta=(ClampMin=0, ClampMax=1))
+	float GibbingWeight = 0.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category=HUD)
+	FLinearColor Tint = FLinearColor::White;
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category=HUD)
+	FLinearColor FaceTint = FLinearColor::White;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category=SlowMotion)
+	bool bTriggersSlowMotion = false;
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category=SlowMotion)
+	bool bSlowMotionOnlyWhenRising = true;
+	// The slow motion cooldown of this tier is cleared once the meter drops this many tiers below it
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category=SlowMotion)
+	int32 SlowMotionCooldownResetDepth = 2;
+};
+
+/**
+ * Every mood tier and what it does to the game. The tiers are baked into a table indexed by the
+ * meter value when loaded, so looking up the tier for a value is a single array read.
+ */
+UCLASS(BlueprintType)
+class UMoodTierTable : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	UMoodTierTable();
+
+	virtual void PostInitProperties() override;
+	virtual void PostLoad() override;
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
+	int32 GetTierIndex(float MoodValue) const
+	{
+		return TierLookup[FMath::Clamp(FMath::FloorToInt32(MoodValue), 0, MaxMoodValue)];
+	}
+	const FMoodTier& GetTier(int32 Index) const { return BakedTiers[Index]; }
+	TConstArrayView<FMoodTier> GetTiers() const { return BakedTiers; }
+	int32 NumTiers() const { return BakedTiers.Num(); }
+	int32 GetTopThreshold() const { return BakedTiers.Last().Threshold; }
+	int32 GetMaxMoodValue() const { return MaxMoodValue; }
+
+	// Edits every tier with the state and bakes the table again
+	void EditTiers(EMoodState State, TFunctionRef<void(FMoodTier&)> Edit);
+
+private:
+	UPROPERTY(EditDefaultsOnly, Category=Mood)
+	TArray<FMoodTier> Tiers;
+	UPROPERTY(EditDefaultsOnly, Category=Mood, meta=(ClampMin=1))
+	int32 MaxMoodValue = 1000;
+
+	// Tiers sorted by threshold, the first one always starts at zero
+	TArray<FMoodTier> BakedTiers;
+	// Tier index for every whole meter value from 0 to MaxMoodValue
+	TArray<uint8> TierLookup;
+
+	void Bake();
+};
@@ -0,0 +1,74 @@
+#include "MoodTimeDilationSubsystem.h"
+
+#include "Engine/World.h"
+#include "GameFramework/WorldSettings.h"
+
+void UMoodTimeDilationSubsystem::PushRequest(const UObject* Owner, float TimeDilation,
+                                             EMoodTimeDilationPriority Priority, float Lifetime) {
+	if (Owner == nullptr) {
+		UE_LOG(LogTemp, Error, TEXT("UMoodTimeDilationSubsystem::PushRequest - Owner is nullptr"));
+		return;
+	}
+
+	Requests.RemoveAll([Owner](const FRequest& Request) { return Request.Owner == Owner; });
+
+	FRequest Request;
+	Request.Owner = Owner;
+	Request.TimeDilation = TimeDilation;
+	Request.Priority = Priority;
+	if (Lifetime > 0.f) {
+		Request.ExpireTime = GetWorld()->GetRealTimeSeconds() + Lifetime;
+		bHasTimedRequests = true;
+	}
+	Requests.Add(Request);
+
+	ResolveTimeDilation();
+}
+
+void UMoodTimeDilationSubsystem::PopRequest(const UObject* Owner) {
+	if (Requests.RemoveAll([Owner](const FRequest& Request) { return Request.Owner == Owner; }) > 0) {
+		ResolveTimeDilation();
+	}
+}
+
+void UMoodTimeDilationSubsystem::Tick(float DeltaTime) {
+	Super::Tick(DeltaTime);
+
+	const auto Now = GetWorld()->GetRealTimeSeconds();
+	const auto NumRemoved = Requests.RemoveAll([Now](const FRequest& Request) {
+		return Request.ExpireTime > 0.0 && Now >= Request.ExpireTime;
+	});
+	if (NumRemoved > 0) {
+		ResolveTimeDilation();
+	}
+}
+
+TStatId UMoodTimeDilationSubsystem::GetStatId() const {
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UMoodTimeDilationSubsystem, STATGROUP_Tickables);
+}
+
+void UMoodTimeDilationSubsystem::ResolveTimeDilation() {
+	// Requests whose owner has been destroyed without popping them are dropped here
+	Requests.RemoveAll([](const FRequest& Request) { return !Request.Owner.IsValid(); });
+
+	// Among equal priorities the latest request wins
+	const FRequest* Winner = nullptr;
+	bHasTimedRequests = false;
+	for (const auto& Request : Requests) {
+		if (Winner == nullptr || Request.Priority >= Winner->Priority) {
+			Winner = &Request;
+		}
+		bHasTimedRequests |= Request.ExpireTime > 0.0;
+	}
+
+	const auto NewTimeDilation = Winner ? Winner->TimeDilation : 1.f;
+	if (NewTimeDilation == ResolvedTimeDilation) {
+		return;
+	}
+
+	ResolvedTimeDilation = NewTimeDilation;
+	if (auto* WorldSettings = GetWorld()->GetWorldSettings()) {
+		WorldSettings->SetTimeDilation(ResolvedTimeDilation);
+	}
+	OnTimeDilationChangedNative.Broadcast(ResolvedTimeDilation);
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "MoodTimeDilationSubsystem.generated.h"
+
+// Higher priorities override lower ones while their request is active
+UENUM(BlueprintType)
+enum EMoodTimeDilationPriority
+{
+	Etd_Execution,
+	Etd_SlowMotion,
+	Etd_Menu
+};
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnTimeDilationChangedNative, float /*TimeDilation*/);
+
+/**
+ * Owns the global time dilation of the world. Anything that wants to slow down or stop time pushes a
+ * request with itself as owner and pops it when done. The request with the highest priority wins,
+ * and the world settings are only written when the resolved value changes.
+ */
+UCLASS()
+class UMoodTimeDilationSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// Broadcast when the resolved time dilation changes
+	FOnTimeDilationChangedNative OnTimeDilationChangedNative;
+
+	// Replaces any request the owner already has. A lifetime above zero pops it after that many real seconds
+	UFUNCTION(BlueprintCallable)
+	void PushRequest(const UObject* Owner, float TimeDilation, EMoodTimeDilationPriority Priority, float Lifetime = 0.f);
+	UFUNCTION(BlueprintCallable)
+	void PopRequest(const UObject* Owner);
+
+	UFUNCTION(BlueprintCallable, BlueprintPure)
+	float GetTimeDilation() const { return ResolvedTimeDilation; }
+	// Time is running, but slower than normal
+	UFUNCTION(BlueprintCallable, BlueprintPure)
+	bool IsSlowMotion() const { return ResolvedTimeDilation > 0.f && ResolvedTimeDilation < 1.f; }
+
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override { return bHasTimedRequests; }
+	virtual TStatId GetStatId() const override;
+
+private:
+	struct FRequest
+	{
+		TWeakObjectPtr<const UObject> Owner;
+		float TimeDilation = 1.f;
+		EMoodTimeDilationPriority Priority = Etd_Execution;
+		// Real time when the request is popped, zero if it lives until its owner pops it
+		double ExpireTime = 0.0;
+	};
+	TArray<FRequest> Requests;
+	bool bHasTimedRequests = false;
+	float ResolvedTimeDilation = 1.f;
+
+	void ResolveTimeDilation();
+};
@@ -15,11 +15,21 @@
 #include "../MoodHealthComponent.h"
 #include "Kismet/GameplayStatics.h"
 #include "Mood/MoodGameMode.h"
+#include "Mood/MoodDeterminismSubsystem.h"
+#include "Mood/MoodTimeDilationSubsystem.h"
+#include "Mood/Telemetry/MoodTelemetrySubsystem.h"
 #include "Mood/Enemies/MoodEnemyCharacter.h"
 #include "Mood/Weapons/MoodWeaponComponent.h"
 
 DEFINE_LOG_CATEGORY(LogTemplateCharacter);
 
+namespace
+{
+	// Names the character's modifiers go under in its attribute component
+	const FName MoodTierModifiers(TEXT("MoodTier"));
+	const FName SlowMotionModifiers(TEXT("SlowMotion"));
+}
+
 //////////////////////////////////////////////////////////////////////////
 // AMoodCharacter
 
@@ -39,26 +49,31 @@ AMoodCharacter::AMoodCharacter()
 	HealthComponent = CreateDefaultSubobject<UMoodHealthComponent>(TEXT("HealthComponent"));
 	WeaponSlotComponent = CreateDefaultSubobject<UMoodWeaponSlotComponent>(TEXT("WeaponSlotComponent"));
 	WeaponSlotComponent->SetMuzzleRoot(FirstPersonCameraComponent);
+	AttributeComponent = CreateDefaultSubobject<UMoodAttributeComponent>(TEXT("AttributeComponent"));
 }
 
 void AMoodCharacter::BeginPlay()
 {
 	Super::BeginPlay();
+
+	AttributeComponent->OnAttributeChangedNative.AddUObject(this, &AMoodCharacter::OnAttributeChanged);
+	GetWorld()->GetSubsystem<UMoodTimeDilationSubsystem>()->OnTimeDilationChangedNative.AddUObject(
+		this, &AMoodCharacter::OnTimeDilationChanged);
 	
 	if (!IsValid(MoodGameMode))
 	{
 		MoodGameMode = Cast<AMoodGameMode>(GetWorld()->GetAuthGameMode());
-		MoodGameMode->OnMoodChanged.AddUniqueDynamic(this, &AMoodCharacter::OnMoodChanged);
+		MoodGameMode->OnMoodChangedNative.AddUObject(this, &AMoodCharacter::OnMoodChanged);
 		MoodGameMode->OnSlowMotionTriggered.AddUniqueDynamic(this, &AMoodCharacter::OnSlowMotionTriggered);
-		MoodGameMode->OnSlowMotionEnded.AddUniqueDynamic(this, &AMoodCharacter::OnSlowMotionEnded);
 	}
 	
+	HurtSoundStream = UMoodDeterminismSubsystem::MakeStream(this, TEXT("HurtSound"));
 	WalkingSpeed = GetCharacterMovement()->MaxWalkSpeed;
 	WalkingFOV = FirstPersonCameraComponent->FieldOfView;
 
-	HealthComponent->OnHurt.AddUniqueDynamic(this, &AMoodCharacter::LoseHealth);
-	HealthComponent->OnDeath.AddUniqueDynamic(this, &AMoodCharacter::KillPlayer);
-	WeaponSlotComponent->OnWeaponUsed.AddUniqueDynamic(this, &AMoodCharacter::ShootCameraShake);
+	HealthComponent->OnHurtNative.AddUObject(this, &AMoodCharacter::LoseHealth);
+	HealthComponent->OnDeathNative.AddUObject(this, &AMoodCharacter::KillPlayer);
+	WeaponSlotComponent->OnWeaponUsedNative.AddUObject(this, &AMoodCharacter::ShootCameraShake);
 }
 
 void AMoodCharacter::Tick(float const DeltaTime)
@@ -97,45 +112,41 @@ void AMoodCharacter::SetupPlayerInputComponent(UInputComponent* PlayerInputCompo
 	// Set up action bindings
 	if (UEnhancedInputComponent* EnhancedInputComponent = Cast<UEnhancedInputComponent>(PlayerInputComponent))
 	{
+		// The input component is rebuilt on every possession, so the recorder found now stays the right one
+		auto* Recorder = UMoodInputRecorderComponent::Get(Controller);
+
 		// Jumping
-		EnhancedInputComponent->BindAction(JumpAction, ETriggerEvent::Started, this, &AMoodCharacter::Jump);
-		EnhancedInputComponent->BindAction(JumpAction, ETriggerEvent::Completed, this, &ACharacter::StopJumping);
+		BindInput(EnhancedInputComponent, Recorder, JumpAction, ETriggerEvent::Started, Emi_Jump);
+		BindInput(EnhancedInputComponent, Recorder, JumpAction, ETriggerEvent::Completed, Emi_StopJumping);
 
 		// Climbing
-		EnhancedInputComponent->BindAction(ClimbAction, ETriggerEvent::Started, this, &AMoodCharacter::AttemptClimb);
-		EnhancedInputComponent->BindAction(ClimbAction, ETriggerEvent::Completed, this, &AMoodCharacter::DontClimb);
+		BindInput(EnhancedInputComponent, Recorder, ClimbAction, ETriggerEvent::Started, Emi_Climb);
+		BindInput(EnhancedInputComponent, Recorder, ClimbAction, ETriggerEvent::Completed, Emi_StopClimbing);
 
 		// Moving
-		EnhancedInputComponent->BindAction(MoveAction, ETriggerEvent::Triggered, this, &AMoodCharacter::Move);
-		EnhancedInputComponent->BindAction(SprintAction, ETriggerEvent::Triggered, this, &AMoodCharacter::Sprint);
-		EnhancedInputComponent->BindAction(SprintAction, ETriggerEvent::Completed, this,
-		                                   &AMoodCharacter::StopSprinting);
+		BindInput(EnhancedInputComponent, Recorder, MoveAction, ETriggerEvent::Triggered, Emi_Move);
+		BindInput(EnhancedInputComponent, Recorder, SprintAction, ETriggerEvent::Triggered, Emi_Sprint);
+		BindInput(EnhancedInputComponent, Recorder, SprintAction, ETriggerEvent::Completed, Emi_StopSprinting);
 
 		// Looking
-		EnhancedInputComponent->BindAction(LookAction, ETriggerEvent::Triggered, this, &AMoodCharacter::Look);
+		BindInput(EnhancedInputComponent, Recorder, LookAction, ETriggerEvent::Triggered, Emi_Look);
 
 		// Attacking
-		EnhancedInputComponent->BindAction(ShootAction, ETriggerEvent::Triggered, this, &AMoodCharacter::ShootWeapon);
-		EnhancedInputComponent->BindAction(ShootAction, ETriggerEvent::Canceled, this,
-		                                   &AMoodCharacter::StopShootWeapon);
-		EnhancedInputComponent->BindAction(ExecuteAction, ETriggerEvent::Triggered, this, &AMoodCharacter::ToggleExecute);
+		BindInput(EnhancedInputComponent, Recorder, ShootAction, ETriggerEvent::Triggered, Emi_Shoot);
+		BindInput(EnhancedInputComponent, Recorder, ShootAction, ETriggerEvent::Canceled, Emi_StopShooting);
+		BindInput(EnhancedInputComponent, Recorder, ExecuteAction, ETriggerEvent::Triggered, Emi_Execute);
 
 		// Weapon Selection
-		EnhancedInputComponent->BindAction(ScrollWeaponAction, ETriggerEvent::Triggered, this,
-		                                   &AMoodCharacter::WeaponScroll);
-		EnhancedInputComponent->BindAction(SelectWeapon1Action, ETriggerEvent::Triggered, this,
-		                                   &AMoodCharacter::SelectWeapon1);
-		EnhancedInputComponent->BindAction(SelectWeapon2Action, ETriggerEvent::Triggered, this,
-		                                   &AMoodCharacter::SelectWeapon2);
-		EnhancedInputComponent->BindAction(SelectWeapon3Action, ETriggerEvent::Triggered, this,
-		                                   &AMoodCharacter::SelectWeapon3);
+		BindInput(EnhancedInputComponent, Recorder, ScrollWeaponAction, ETriggerEvent::Triggered, Emi_ScrollWeapon);
+		BindInput(EnhancedInputComponent, Recorder, SelectWeapon1Action, ETriggerEvent::Triggered, Emi_SelectWeapon1);
+		BindInput(EnhancedInputComponent, Recorder, SelectWeapon2Action, ETriggerEvent::Triggered, Emi_SelectWeapon2);
+		BindInput(EnhancedInputComponent, Recorder, SelectWeapon3Action, ETriggerEvent::Triggered, Emi_SelectWeapon3);
 
 		// Interact 
-		EnhancedInputComponent->BindAction(InteractAction, ETriggerEvent::Triggered, this,
-		                                   &AMoodCharacter::ToggleInteraction);
+		BindInput(EnhancedInputComponent, Recorder, InteractAction, ETriggerEvent::Triggered, Emi_Interact);
 
 		// Pausing
-		EnhancedInputComponent->BindAction(PauseAction, ETriggerEvent::Triggered, this, &AMoodCharacter::PauseGame);
+		BindInput(EnhancedInputComponent, Recorder, PauseAction, ETriggerEvent::Triggered, Emi_Pause);
 	}
 
 	else
@@ -147,6 +158,49 @@ void AMoodCharacter::SetupPlayerInputComponent(UInputComponent* PlayerInputCompo
 	}
 }
 
+void AMoodCharacter::BindInput(UEnhancedInputComponent* InputComponent, UMoodInputRecorderComponent* InputRecorder,
+                               const UInputAction* Action, ETriggerEvent TriggerEvent, EMoodInput Input)
+{
+	TWeakObjectPtr<UMoodInputRecorderComponent> WeakRecorder = InputRecorder;
+	InputComponent->BindActionValueLambda(Action, TriggerEvent, [this, WeakRecorder, Input](const FInputActionValue& Value)
+	{
+		// A replay drives the character on its own, live input would make it diverge
+		if (auto* Recorder = WeakRecorder.Get())
+		{
+			if (Recorder->IsReplaying())
+				return;
+			Recorder->RecordInput(Input, Value);
+		}
+
+		DispatchInput(Input, Value);
+	});
+}
+
+void AMoodCharacter::DispatchInput(EMoodInput Input, const FInputActionValue& Value)
+{
+	switch (Input)
+	{
+	case Emi_Jump: Jump(); break;
+	case Emi_StopJumping: StopJumping(); break;
+	case Emi_Climb: AttemptClimb(); break;
+	case Emi_StopClimbing: DontClimb(); break;
+	case Emi_Move: Move(Value); break;
+	case Emi_Sprint: Sprint(); break;
+	case Emi_StopSprinting: StopSprinting(); break;
+	case Emi_Look: Look(Value); break;
+	case Emi_Shoot: ShootWeapon(); break;
+	case Emi_StopShooting: StopShootWeapon(); break;
+	case Emi_Execute: ToggleExecute(); break;
+	case Emi_ScrollWeapon: WeaponScroll(Value); break;
+	case Emi_SelectWeapon1: SelectWeapon1(); break;
+	case Emi_SelectWeapon2: SelectWeapon2(); break;
+	case Emi_SelectWeapon3: SelectWeapon3(); break;
+	case Emi_Interact: ToggleInteraction(); break;
+	case Emi_Pause: PauseGame(); break;
+	default: break;
+	}
+}
+
 void AMoodCharacter::CheckPlayerState()
 {
 	switch (CurrentState)
@@ -205,53 +259,32 @@ void AMoodCharacter::CheckPlayerState()
 
 void AMoodCharacter::OnMoodChanged(EMoodState NewState)
 {
-	switch (NewState)
-	{
-	case Ems_Mood666:
-		MoodSpeedPercent = 1.5f;
-		MoodDamagePercent = 2.f;
-		MoodHealthLoss = 0.9f;
-		break;
-	case Ems_Mood444:
-		MoodSpeedPercent = 1.2f;
-		MoodDamagePercent = 1.6f;
-		MoodHealthLoss = 0.9f;
-		break;
-	case Ems_Mood222:
-		MoodSpeedPercent = 1.1f;
-		MoodDamagePercent = 1.3f;
-		MoodHealthLoss = 1.f;
-		break;
-	case Ems_NoMood:
-		MoodSpeedPercent = 1.f;
-		MoodDamagePercent = 1.f;
-		MoodHealthLoss = 1.f;
-		break;
-	default:
-		return;
-	}
+	const auto& MoodTier = MoodGameMode->GetMoodTier();
+	AttributeComponent->SetModifier(MoodTierModifiers, Ema_MoveSpeed, Emo_Multiply, MoodTier.SpeedMultiplier);
+	AttributeComponent->SetModifier(MoodTierModifiers, Ema_Damage, Emo_Multiply, MoodTier.DamageMultiplier);
+	AttributeComponent->SetModifier(MoodTierModifiers, Ema_HealthLoss, Emo_Multiply, MoodTier.HealthLossMultiplier);
 
-	ActivateHealthRegen(NewState);
-	WeaponSlotComponent->SetDamageMultiplier(MoodDamagePercent);
-	HealthComponent->AlterHealthLoss(MoodHealthLoss);
+	ActivateHealthRegen(MoodTier.bRegeneratesHealth);
 }
 
-void AMoodCharacter::OnSlowMotionTriggered(EMoodState NewState)
+void AMoodCharacter::OnTimeDilationChanged(float TimeDilation)
 {
-	bIsSlowMotion = true;
-	HealthComponent->Heal(50);
-	SetWeaponFireRate();
+	if (GetWorld()->GetSubsystem<UMoodTimeDilationSubsystem>()->IsSlowMotion())
+		AttributeComponent->SetModifier(SlowMotionModifiers, Ema_LookSpeed, Emo_Multiply, SlowMotionCameraSpeed);
+	else
+		AttributeComponent->RemoveModifiers(SlowMotionModifiers);
 }
 
-void AMoodCharacter::OnSlowMotionEnded()
+// Only the health loss lives somewhere else, everything else reads its attribute when it's used
+void AMoodCharacter::OnAttributeChanged(EMoodAttribute Attribute, float NewValue)
 {
-	bIsSlowMotion = false;
-	SetWeaponFireRate();
+	if (Attribute == Ema_HealthLoss)
+		HealthComponent->AlterHealthLoss(NewValue);
 }
 
-void AMoodCharacter::SetWeaponFireRate()
+void AMoodCharacter::OnSlowMotionTriggered(EMoodState NewState)
 {
-	WeaponSlotComponent->GetSelectedWeapon()->SetSlowMotion(bIsSlowMotion ? true : false);
+	HealthComponent->Heal(50);
 }
 
 void AMoodCharacter::AttemptClimb()
@@ -270,7 +303,7 @@ void AMoodCharacter::Move(const FInputActionValue& Value)
 
 	if (Controller != nullptr && CurrentState != Eps_NoControl)
 	{
-		const FVector2D MoodSpeed = MovementVector * MoodSpeedPercent;
+		const FVector2D MoodSpeed = MovementVector * AttributeComponent->GetValue(Ema_MoveSpeed);
 		AddMovementInput(GetActorForwardVector(), MoodSpeed.Y);
 		AddMovementInput(GetActorRightVector(), MoodSpeed.X);
 	}
@@ -282,18 +315,9 @@ void AMoodCharacter::Look(const FInputActionValue& Value)
 
 	if (Controller != nullptr && CurrentState != Eps_NoControl)
 	{
-		FVector2D TotalLookAxis = LookAxisVector * CameraSpeed;
-
-		if (bIsSlowMotion)
-		{
-			AddControllerYawInput(TotalLookAxis.X *= SlowMotionCameraSpeed);
-			AddControllerPitchInput(TotalLookAxis.Y *= SlowMotionCameraSpeed);		
-		}
-		else
-		{
-			AddControllerYawInput(TotalLookAxis.X);
-			AddControllerPitchInput(TotalLookAxis.Y);
-		}
+		const FVector2D TotalLookAxis = LookAxisVector * CameraSpeed * AttributeComponent->GetValue(Ema_LookSpeed);
+		AddControllerYawInput(TotalLookAxis.X);
+		AddControllerPitchInput(TotalLookAxis.Y);
 	}
 }
 
@@ -308,8 +332,6 @@ void AMoodCharacter::WeaponScroll(const FInputActionValue& Value)
 		WeaponSlotComponent->SelectNextWeapon();
 	else if (ScrollDirection < 0)
 		WeaponSlotComponent->SelectPreviousWeapon();
-
-	SetWeaponFireRate();		
 }
 
 void AMoodCharacter::SelectWeapon1()
@@ -318,7 +340,6 @@ void AMoodCharacter::SelectWeapon1()
 		return;
 
 	WeaponSlotComponent->SelectWeapon(0);
-	SetWeaponFireRate();
 }
 
 void AMoodCharacter::SelectWeapon2()
@@ -327,7 +348,6 @@ void AMoodCharacter::SelectWeapon2()
 		return;
 
 	WeaponSlotComponent->SelectWeapon(1);
-	SetWeaponFireRate();
 }
 
 void AMoodCharacter::SelectWeapon3()
@@ -336,7 +356,6 @@ void AMoodCharacter::SelectWeapon3()
 		return;
 
 	WeaponSlotComponent->SelectWeapon(2);
-	SetWeaponFireRate();
 }
 
 void AMoodCharacter::PauseGame()
@@ -359,7 +378,7 @@ void AMoodCharacter::LoseHealth(int Amount, int NewHealth)
 {
 	MoodGameMode->ChangeMoodValue(-Amount);
 
-	if (const int RandomValue = FMath::RandRange(0, 9); RandomValue > 6)
+	if (const int RandomValue = HurtSoundStream.RandRange(0, 9); RandomValue > 6)
 		UGameplayStatics::PlaySound2D(GetWorld(), PlayerHurtSound);
 }
 
@@ -389,7 +408,7 @@ void AMoodCharacter::StopSprinting()
 
 void AMoodCharacter::FindExecutee()
 {
-	if (CurrentState == Eps_ClimbingLedge || CurrentState == Eps_NoControl || bIsExecuting /*|| bIsSlowMotion*/)
+	if (CurrentState == Eps_ClimbingLedge || CurrentState == Eps_NoControl || bIsExecuting)
 		return;
 	
 	FHitResult HitResult;
@@ -420,7 +439,7 @@ void AMoodCharacter::FindExecutee()
 		bHasFoundExecutableEnemy = false;
 		return;
 	}
-	ExecuteeHealth = Executee->FindComponentByClass<UMoodHealthComponent>();
+	ExecuteeHealth = Executee->GetHealthComponent();
 
 	if (!IsValid(ExecuteeHealth))
 	{
@@ -477,7 +496,7 @@ void AMoodCharacter::ToggleExecute()
 	
 	bIsExecuting = true;
 	CurrentState = Eps_NoControl;
-	UGameplayStatics::SetGlobalTimeDilation(GetWorld(), ExecutionTimeDilation);
+	GetWorld()->GetSubsystem<UMoodTimeDilationSubsystem>()->PushRequest(this, ExecutionTimeDilation, Etd_Execution);
 	UGameplayStatics::PlaySound2D(GetWorld(), ExecutionSprint);
 }
 
@@ -505,7 +524,7 @@ void AMoodCharacter::MoveToExecutee()
 	if (TimeSinceExecutionStart >= 1.f)
 	{
 		UE_LOG(LogTemp, Error, TEXT("AMoodCharacter: Couldn't reach enemy."))
-		UGameplayStatics::SetGlobalTimeDilation(GetWorld(), 1.f);
+		GetWorld()->GetSubsystem<UMoodTimeDilationSubsystem>()->PopRequest(this);
 		bIsExecuting = false;
 		bHasFoundExecutableEnemy = false;
 		CurrentState = Eps_Walking;
@@ -517,7 +536,9 @@ void AMoodCharacter::ExecuteFoundEnemy()
 	if (IsValid(Executee) && IsValid(ExecuteeHealth))
 	{
 		GetWorld()->GetFirstPlayerController()->PlayerCameraManager->StartCameraShake(ExecuteShake, 1.f);
-		ExecuteeHealth->Hurt(ExecutionDamage);
+		ExecuteeHealth->Hurt(ExecutionDamage, this);
+		if (auto* Telemetry = UMoodTelemetrySubsystem::Get(this))
+			Telemetry->RecordExecution(this, Executee, ExecutionDamage);
 		MoodGameMode->ChangeMoodValue(ExecutionDamage);
 		HealthComponent->Heal(ExecutionHealing);
 		Executee = nullptr;
@@ -526,7 +547,7 @@ void AMoodCharacter::ExecuteFoundEnemy()
 	else
 		UE_LOG(LogTemp, Error, TEXT("AMoodCharacter: Executee or ExecuteeHealth are invalid."))
 
-	UGameplayStatics::SetGlobalTimeDilation(GetWorld(), 1.f);
+	GetWorld()->GetSubsystem<UMoodTimeDilationSubsystem>()->PopRequest(this);
 	bIsExecuting = false;
 	bHasFoundExecutableEnemy = false;
 	CurrentState = Eps_Walking;
@@ -591,6 +612,8 @@ void AMoodCharacter::FindLedge()
 void AMoodCharacter::KillPlayer(AActor* DeadActor)
 {
 	bIsDead = true;
+	if (auto* Telemetry = UMoodTelemetrySubsystem::Get(this))
+		Telemetry->RecordPlayerDeath(this);
 	MoodGameMode->ResetMoodValue();
 	CurrentState = Eps_NoControl;
 }
@@ -600,9 +623,9 @@ void AMoodCharacter::RevivePlayer()
 	HealthComponent->Reset();
 }
 
-void AMoodCharacter::ActivateHealthRegen(EMoodState CurrentMood)
+void AMoodCharacter::ActivateHealthRegen(bool bShouldRegenerate)
 {
-	bIsGeneratingHealth = CurrentMood == Ems_Mood666 ? 1 : 0;
+	bIsGeneratingHealth = bShouldRegenerate;
 }
 
 void AMoodCharacter::RegenerateHealth()
@@ -5,7 +5,10 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Character.h"
 #include "Logging/LogMacros.h"
+#include "Mood/MoodAttributeComponent.h"
+#include "Mood/MoodDamageable.h"
 #include "Mood/MoodGameMode.h"
+#include "Mood/Player/MoodInputRecorderComponent.h"
 #include "MoodCharacter.generated.h"
 
 class AMoodEnemyCharacter;
@@ -16,12 +19,14 @@ class USkeletalMeshComponent;
 class UCameraComponent;
 class UBoxComponent;
 class UInputAction;
+class UEnhancedInputComponent;
 class UInputMappingContext;
 class UMoodWeaponSlotComponent;
 class UMoodHealthComponent;
 class AMoodGameMode;
 struct FInputActionValue;
 enum EMoodState;
+enum class ETriggerEvent : uint8;
 
 DECLARE_LOG_CATEGORY_EXTERN(LogTemplateCharacter, Log, All);
 
@@ -37,7 +42,7 @@ enum EPlayerState
 DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnPaused);
 
 UCLASS(config=Game)
-class AMoodCharacter : public ACharacter
+class AMoodCharacter : public ACharacter, public IMoodDamageable
 {
 	GENERATED_BODY()
 
@@ -53,6 +58,10 @@ class AMoodCharacter : public ACharacter
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "true"))
 	UMoodWeaponSlotComponent* WeaponSlotComponent;
 
+	/** Attribute Component, final values of the mood and slow motion multipliers */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "true"))
+	UMoodAttributeComponent* AttributeComponent;
+
 	/** Jump Input Action */
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category=Input, meta=(AllowPrivateAccess = "true"))
 	UInputAction* JumpAction;
@@ -138,17 +147,15 @@ public:
 	void ResetPlayer();
 	UFUNCTION(BlueprintCallable)
 	void OnLoseFocus() { StopShootWeapon(); }
+
+	// Runs the handler bound to Input, used by live input and by input replays alike
+	void DispatchInput(EMoodInput Input, const FInputActionValue& Value);
 	
 private:
 	float WalkingSpeed;
 	float WalkingFOV;
 	float TimeSinceClimbStart = 0.f;
 	
-	float MoodSpeedPercent = 1.f;
-	float MoodDamagePercent = 1.f;
-	float CurrentMoodDamagePercent = 1.f;
-	float MoodHealthLoss = 1.f;
-	
 	UPROPERTY(EditDefaultsOnly)
 	float DeathFallSpeed = 20.f;
 
@@ -193,11 +200,12 @@ private:
 	bool bHasRespawned = false;
 	bool bCanClimb = false;
 	bool bIsExecuting = false;
-	bool bIsSlowMotion = false;
 	bool bIsGeneratingHealth = false;
 
 	float TimeSinceExecutionStart = 0.f;
 
+	FRandomStream HurtSoundStream;
+
 protected:
 	void CheckPlayerState();
 
@@ -205,9 +213,8 @@ protected:
 	void OnMoodChanged(EMoodState NewState);
 	UFUNCTION()
 	void OnSlowMotionTriggered(EMoodState NewState);
-	UFUNCTION()
-	void OnSlowMotionEnded();
-	void SetWeaponFireRate();
+	void OnTimeDilationChanged(float TimeDilation);
+	void OnAttributeChanged(EMoodAttribute Attribute, float NewValue);
 	
 	void AttemptClimb();
 	void DontClimb();
@@ -235,7 +242,7 @@ protected:
 	void KillPlayer(AActor* DeadActor);
 	UFUNCTION()
 	void RevivePlayer();
-	void ActivateHealthRegen(EMoodState CurrentMood);
+	void ActivateHealthRegen(bool bShouldRegenerate);
 	void RegenerateHealth();
 	void DeathCamMovement();
 	
@@ -261,6 +268,9 @@ protected:
 	virtual void SetupPlayerInputComponent(UInputComponent* InputComponent) override;
 	// End of APawn interface
 
+	void BindInput(UEnhancedInputComponent* InputComponent, UMoodInputRecorderComponent* InputRecorder,
+	               const UInputAction* Action, ETriggerEvent TriggerEvent, EMoodInput Input);
+
 	UPROPERTY()
 	AMoodGameMode* MoodGameMode = nullptr;
 
@@ -272,6 +282,8 @@ protected:
 	UMoodHealthComponent* ExecuteeHealth = nullptr;
 
 public:
+	virtual UMoodHealthComponent* GetHealthComponent() const override { return HealthComponent; }
+
  	/** Returns FirstPersonCameraComponent subobject **/
 	UCameraComponent* GetFirstPersonCameraComponent() const { return FirstPersonCameraComponent; }
 };
\ No newline at end of file
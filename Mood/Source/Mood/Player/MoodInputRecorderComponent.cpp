@@ -0,0 +1,267 @@
+#include "MoodInputRecorderComponent.h"
+
+#include "MoodCharacter.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/FileManager.h"
+#include "Kismet/KismetSystemLibrary.h"
+#include "Misc/App.h"
+#include "Misc/Paths.h"
+#include "Mood/MoodDeterminismSubsystem.h"
+#include "Serialization/MemoryWriter.h"
+
+static_assert(Emi_Count < 64, "Inputs share their byte with the value type");
+
+UMoodInputRecorderComponent::UMoodInputRecorderComponent()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+}
+
+UMoodInputRecorderComponent* UMoodInputRecorderComponent::Get(const AController* Controller)
+{
+	return Controller ? Controller->FindComponentByClass<UMoodInputRecorderComponent>() : nullptr;
+}
+
+void UMoodInputRecorderComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	const auto* PlayerController = GetOwner<APlayerController>();
+	if (PlayerController == nullptr || !PlayerController->IsLocalController())
+		return;
+
+	FString Name;
+	if (FParse::Value(FCommandLine::Get(), TEXT("MoodReplayInput="), Name))
+		StartReplay(Name);
+	else if (FParse::Value(FCommandLine::Get(), TEXT("MoodRecordInput="), Name))
+		StartRecording(Name);
+}
+
+void UMoodInputRecorderComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (RecordingFile != nullptr)
+	{
+		RecordingFile->Close();
+		RecordingFile.Reset();
+		UE_LOG(LogTemp, Log, TEXT("UMoodInputRecorderComponent: Recorded %u frames"), FrameCount);
+	}
+	ReplayFile.Reset();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+FString UMoodInputRecorderComponent::GetRecordingPath(const FString& Name) const
+{
+	const auto MapName = UWorld::RemovePIEPrefix(GetWorld()->GetMapName());
+	return FPaths::ProjectSavedDir() / TEXT("InputRecordings") / FString::Printf(TEXT("%s_%s.minp"), *Name, *MapName);
+}
+
+void UMoodInputRecorderComponent::StartRecording(const FString& Name)
+{
+	const auto Path = GetRecordingPath(Name);
+	RecordingFile = TUniquePtr<FArchive>(IFileManager::Get().CreateFileWriter(*Path));
+	if (RecordingFile == nullptr)
+	{
+		UE_LOG(LogTemp, Error, TEXT("UMoodInputRecorderComponent: Couldn't create %s"), *Path);
+		return;
+	}
+
+	const auto* Determinism = GetWorld()->GetGameInstance()->GetSubsystem<UMoodDeterminismSubsystem>();
+	auto Magic = FileMagic;
+	auto Version = FileVersion;
+	auto MapName = UWorld::RemovePIEPrefix(GetWorld()->GetMapName());
+	auto SessionSeed = Determinism ? Determinism->GetSessionSeed() : 0;
+	*RecordingFile << Magic << Version << MapName << SessionSeed;
+
+	UE_LOG(LogTemp, Log, TEXT("UMoodInputRecorderComponent: Recording input to %s"), *Path);
+}
+
+void UMoodInputRecorderComponent::StartReplay(const FString& Name)
+{
+	const auto Path = GetRecordingPath(Name);
+	ReplayFile = TUniquePtr<FArchive>(IFileManager::Get().CreateFileReader(*Path));
+	if (ReplayFile == nullptr)
+	{
+		UE_LOG(LogTemp, Error, TEXT("UMoodInputRecorderComponent: Couldn't open %s"), *Path);
+		return;
+	}
+
+	uint32 Magic = 0;
+	uint16 Version = 0;
+	FString MapName;
+	int32 SessionSeed = 0;
+	*ReplayFile << Magic << Version << MapName << SessionSeed;
+	if (Magic != FileMagic || Version != FileVersion)
+	{
+		UE_LOG(LogTemp, Error, TEXT("UMoodInputRecorderComponent: %s is not a version %d input recording"), *Path,
+		       FileVersion);
+		ReplayFile.Reset();
+		return;
+	}
+
+	// Still replayed, the random streams just won't line up with the recorded session
+	const auto* Determinism = GetWorld()->GetGameInstance()->GetSubsystem<UMoodDeterminismSubsystem>();
+	if (Determinism == nullptr || !Determinism->IsDeterministic() || Determinism->GetSessionSeed() != SessionSeed)
+		UE_LOG(LogTemp, Warning, TEXT("UMoodInputRecorderComponent: %s was recorded with -MoodSeed=%d"), *Path, SessionSeed);
+
+	FApp::SetUseFixedTimeStep(true);
+	if (!ReadNextFrameDelta())
+		StopReplay();
+
+	UE_LOG(LogTemp, Log, TEXT("UMoodInputRecorderComponent: Replaying input from %s"), *Path);
+}
+
+void UMoodInputRecorderComponent::StopReplay()
+{
+	ReplayFile.Reset();
+	UE_LOG(LogTemp, Log, TEXT("UMoodInputRecorderComponent: Replay finished after %u frames"), FrameCount);
+
+	// Replays are run unattended, nothing left to do once the input runs out
+	UKismetSystemLibrary::QuitGame(this, GetOwner<APlayerController>(), EQuitPreference::Quit, false);
+}
+
+void UMoodInputRecorderComponent::RecordInput(EMoodInput Input, const FInputActionValue& Value)
+{
+	// Pausing hands control to the menus, which the recording can't play back
+	if (RecordingFile == nullptr || Input == Emi_Pause)
+		return;
+
+	FMemoryWriter Writer(FrameBuffer);
+	Writer.Seek(FrameBuffer.Num());
+
+	const auto ValueType = Value.GetValueType();
+	auto Header = static_cast<uint8>(Input | static_cast<uint8>(ValueType) << 6);
+	Writer << Header;
+
+	const auto Axes = Value.Get<FVector>();
+	switch (ValueType)
+	{
+	case EInputActionValueType::Boolean:
+		{
+			auto bValue = static_cast<uint8>(Value.Get<bool>());
+			Writer << bValue;
+			break;
+		}
+	case EInputActionValueType::Axis1D:
+		{
+			auto X = static_cast<float>(Axes.X);
+			Writer << X;
+			break;
+		}
+	case EInputActionValueType::Axis2D:
+		{
+			auto Axis = FVector2f(Axes.X, Axes.Y);
+			Writer << Axis;
+			break;
+		}
+	case EInputActionValueType::Axis3D:
+		{
+			auto Axis = FVector3f(Axes);
+			Writer << Axis;
+			break;
+		}
+	}
+}
+
+void UMoodInputRecorderComponent::OnInputProcessed(bool bGamePaused)
+{
+	if (bGamePaused)
+	{
+		FrameBuffer.Reset();
+		return;
+	}
+
+	if (RecordingFile != nullptr)
+	{
+		// Raw frame time, time dilation is part of the game state and gets replayed with it
+		auto Marker = FrameMarker;
+		auto DeltaTime = static_cast<float>(FApp::GetDeltaTime());
+		*RecordingFile << Marker << DeltaTime;
+		RecordingFile->Serialize(FrameBuffer.GetData(), FrameBuffer.Num());
+		FrameBuffer.Reset();
+		FrameCount++;
+	}
+	else if (ReplayFile != nullptr)
+	{
+		ReplayFrame();
+	}
+}
+
+bool UMoodInputRecorderComponent::ReadNextFrameDelta()
+{
+	if (ReplayFile->AtEnd())
+		return false;
+
+	uint8 Marker = 0;
+	float DeltaTime = 0.f;
+	*ReplayFile << Marker << DeltaTime;
+	if (Marker != FrameMarker || ReplayFile->IsError())
+	{
+		UE_LOG(LogTemp, Error, TEXT("UMoodInputRecorderComponent: Recording is corrupt at frame %u"), FrameCount);
+		return false;
+	}
+
+	// Takes effect from the next engine tick, which is the frame this delta was recorded for
+	FApp::SetFixedDeltaTime(DeltaTime);
+	return true;
+}
+
+void UMoodInputRecorderComponent::ReplayFrame()
+{
+	auto* Character = Cast<AMoodCharacter>(GetOwner<APlayerController>()->GetPawn());
+
+	while (!ReplayFile->AtEnd())
+	{
+		uint8 Header = 0;
+		*ReplayFile << Header;
+		if (Header == FrameMarker)
+		{
+			// Put the marker back for ReadNextFrameDelta
+			ReplayFile->Seek(ReplayFile->Tell() - 1);
+			break;
+		}
+
+		const auto Input = static_cast<EMoodInput>(Header & 0x3F);
+		const auto ValueType = static_cast<EInputActionValueType>(Header >> 6);
+		FVector Axes = FVector::ZeroVector;
+		switch (ValueType)
+		{
+		case EInputActionValueType::Boolean:
+			{
+				uint8 bValue = 0;
+				*ReplayFile << bValue;
+				Axes.X = bValue;
+				break;
+			}
+		case EInputActionValueType::Axis1D:
+			{
+				float X = 0.f;
+				*ReplayFile << X;
+				Axes.X = X;
+				break;
+			}
+		case EInputActionValueType::Axis2D:
+			{
+				FVector2f Axis;
+				*ReplayFile << Axis;
+				Axes = FVector(Axis.X, Axis.Y, 0.f);
+				break;
+			}
+		case EInputActionValueType::Axis3D:
+			{
+				FVector3f Axis;
+				*ReplayFile << Axis;
+				Axes = FVector(Axis);
+				break;
+			}
+		}
+
+		if (Character != nullptr && Input < Emi_Count)
+			Character->DispatchInput(Input, FInputActionValue(ValueType, Axes));
+	}
+
+	FrameCount++;
+	if (!ReadNextFrameDelta())
+		StopReplay();
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "InputActionValue.h"
+#include "MoodInputRecorderComponent.generated.h"
+
+// Every input the character binds. Stored as a byte in recordings, so only ever append to this
+enum EMoodInput : uint8
+{
+	Emi_Jump,
+	Emi_StopJumping,
+	Emi_Climb,
+	Emi_StopClimbing,
+	Emi_Move,
+	Emi_Sprint,
+	Emi_StopSprinting,
+	Emi_Look,
+	Emi_Shoot,
+	Emi_StopShooting,
+	Emi_Execute,
+	Emi_ScrollWeapon,
+	Emi_SelectWeapon1,
+	Emi_SelectWeapon2,
+	Emi_SelectWeapon3,
+	Emi_Interact,
+	Emi_Pause,
+	Emi_Count
+};
+
+/**
+ * Records the character's input actions frame by frame into Saved/InputRecordings, or plays such a
+ * recording back instead of the live input. Frames are stored with their real delta time and replayed
+ * with it as a fixed step, so together with the session seed the same fight happens again.
+ *
+ * Record:  Mood -MoodRecordInput=Fight -MoodSeed=42
+ * Replay:  Mood /Game/Levels/Level1 -MoodReplayInput=Fight -MoodSeed=42 -nullrhi -unattended
+ *
+ * One file is written per level (Fight_Level1.minp), and the replay picks the file for the level it
+ * runs in. Paused frames and the pause input are not recorded, since menus are driven by the UI.
+ */
+UCLASS()
+class UMoodInputRecorderComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	static constexpr uint32 FileMagic = 0x504E494D; // "MINP"
+	static constexpr uint16 FileVersion = 1;
+
+	UMoodInputRecorderComponent();
+
+	static UMoodInputRecorderComponent* Get(const AController* Controller);
+
+	bool IsRecording() const { return RecordingFile != nullptr; }
+	bool IsReplaying() const { return ReplayFile != nullptr; }
+
+	void RecordInput(EMoodInput Input, const FInputActionValue& Value);
+	// Called by the player controller once the frame's input has been handled
+	void OnInputProcessed(bool bGamePaused);
+
+protected:
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+private:
+	static constexpr uint8 FrameMarker = 0xFF;
+
+	TUniquePtr<FArchive> RecordingFile;
+	TUniquePtr<FArchive> ReplayFile;
+	// Inputs of the current frame, written behind the frame's delta time once the frame is done
+	TArray<uint8> FrameBuffer;
+	uint32 FrameCount = 0;
+
+	FString GetRecordingPath(const FString& Name) const;
+	void StartRecording(const FString& Name);
+	void StartReplay(const FString& Name);
+	void StopReplay();
+	bool ReadNextFrameDelta();
+	void ReplayFrame();
+};
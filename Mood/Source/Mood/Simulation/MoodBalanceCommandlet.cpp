@@ -0,0 +1,491 @@
+#include "MoodBalanceCommandlet.h"
+
+#include "Async/ParallelFor.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "Misc/FileHelper.h"
+#include "Mood/MoodGameMode.h"
+#include "Mood/MoodHealthComponent.h"
+#include "Mood/Enemies/MoodEnemyCharacter.h"
+#include "Mood/Weapons/MoodWeaponDefinition.h"
+#include "MoodRules.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogMoodBalance, Log, All);
+
+namespace
+{
+	struct FBalanceConfig
+	{
+		MoodRules::FMoodMeterRules Mood;
+		TArray<FMoodTier> Tiers;
+		MoodRules::FWeaponRules Weapon;
+		MoodRules::FSpreadTable Spread;
+		MoodRules::FHealthRules PlayerHealth;
+		MoodRules::FHealthRules EnemyHealth;
+
+		int32 Encounters = 100000;
+		int32 Seed = 0;
+		float Duration = 60.f;
+		float Step = 1.f / 60.f;
+
+		// Chance that the player is on target when a shot goes off, the spread decides which pellets land
+		float Accuracy = 0.6f;
+		float EnemyDistance = 1000.f;
+		float EnemyHalfWidth = 40.f;
+		float EnemyHalfHeight = 90.f;
+
+		int32 EnemyCount = 3;
+		int32 EnemyDamage = 10;
+		float EnemyAttackInterval = 1.5f;
+		float EnemyAccuracy = 0.3f;
+		float EnemyRespawnDelay = 1.f;
+
+		// The character heals this much when slow motion starts, and over time in tiers that regenerate
+		int32 SlowMotionHealing = 50;
+		float HealthGenerationDelay = 1.f;
+		int32 HealthGenerationAmount = 3;
+
+		float TimeToKillBucketSize = 0.25f;
+		int32 TimeToKillBuckets = 40;
+	};
+
+	struct FBalanceStats
+	{
+		TArray<double> TimeInTier;
+		// The last bucket also counts every kill slower than it
+		TArray<int64> TimeToKill;
+		double TotalTimeToKill = 0.0;
+		double SimulatedTime = 0.0;
+		int64 Kills = 0;
+		int64 Deaths = 0;
+		int64 SlowMotions = 0;
+
+		void Init(const FBalanceConfig& Config) {
+			TimeInTier.Init(0.0, Config.Tiers.Num());
+			TimeToKill.Init(0, Config.TimeToKillBuckets);
+		}
+
+		void Merge(const FBalanceStats& Other) {
+			for (auto i = 0; i < TimeInTier.Num(); i++) {
+				TimeInTier[i] += Other.TimeInTier[i];
+			}
+			for (auto i = 0; i < TimeToKill.Num(); i++) {
+				TimeToKill[i] += Other.TimeToKill[i];
+			}
+			TotalTimeToKill += Other.TotalTimeToKill;
+			SimulatedTime += Other.SimulatedTime;
+			Kills += Other.Kills;
+			Deaths += Other.Deaths;
+			SlowMotions += Other.SlowMotions;
+		}
+
+		// Upper edge of the bucket the given fraction of kills fall within
+		float GetTimeToKillPercentile(float Fraction, float BucketSize) const {
+			const auto Target = static_cast<int64>(FMath::CeilToDouble(Kills * Fraction));
+			int64 Count = 0;
+			for (auto i = 0; i < TimeToKill.Num(); i++) {
+				Count += TimeToKill[i];
+				if (Count >= Target) {
+					return (i + 1) * BucketSize;
+				}
+			}
+			return TimeToKill.Num() * BucketSize;
+		}
+	};
+
+	/**
+	 * One player fighting a steady stream of enemies until they die or the encounter runs out. The
+	 * mood meter is stepped the same way AMoodGameMode drives it: hits are collected during a step
+	 * and applied at the end of it, and decay is settled from the time of the last change.
+	 */
+	class FEncounter
+	{
+	public:
+		FEncounter(const FBalanceConfig& InConfig, const FRandomStream& InStream, FBalanceStats& InStats)
+			: Config(InConfig), Stream(InStream), Stats(InStats) {}
+
+		void Run() {
+			PlayerHealth = Config.PlayerHealth.MaxHealth;
+			MoodDecayStartTime = Config.Mood.TimeIdleBeforeMoodLoss;
+			SlowMotionReadyTimes.Init(0.0, Config.Tiers.Num());
+
+			Enemies.SetNum(Config.EnemyCount);
+			for (auto& Enemy : Enemies) {
+				Enemy.Health = Config.EnemyHealth.MaxHealth;
+				Enemy.TimeToAttack = Stream.FRandRange(0.f, Config.EnemyAttackInterval);
+			}
+
+			while (Now < Config.Duration) {
+				Now += Config.Step;
+
+				UpdateTimers();
+				FireWeapon();
+				AttackPlayer();
+				RegenerateHealth();
+				ApplyPendingMoodChanges();
+				Stats.TimeInTier[MoodTier] += Config.Step;
+
+				if (PlayerHealth <= 0) {
+					Stats.Deaths++;
+					break;
+				}
+			}
+
+			Stats.SimulatedTime += Now;
+		}
+
+	private:
+		struct FEnemy
+		{
+			int32 Health = 0;
+			float TimeToAttack = 0.f;
+			// Negative until the player first shoots at it
+			double FirstShotTime = -1.0;
+			double RespawnTime = 0.0;
+		};
+
+		const FBalanceConfig& Config;
+		FRandomStream Stream;
+		FBalanceStats& Stats;
+		double Now = 0.0;
+
+		float MoodValue = 0.f;
+		double MoodTimestamp = 0.0;
+		double MoodDecayStartTime = 0.0;
+		int32 MoodTier = 0;
+		int32 PendingMoodDelta = 0;
+		bool bHasPendingDamageReset = false;
+		bool bCanLoseMood = true;
+		double KeepMoodEndTime = 0.0;
+		bool bIsChangingMood = false;
+		double SlowMotionStartTime = 0.0;
+		double SlowMotionEndTime = 0.0;
+		TArray<double> SlowMotionReadyTimes;
+
+		int32 PlayerHealth = 0;
+		double NextShotTime = 0.0;
+		float TimeSinceHealthRegenerated = 0.f;
+		TArray<FEnemy> Enemies;
+
+		const FMoodTier& GetMoodTier() const { return Config.Tiers[MoodTier]; }
+
+		void UpdateTimers() {
+			if (bIsChangingMood && Now >= SlowMotionEndTime) {
+				MoodTimestamp = Now;
+				MoodDecayStartTime += Now - SlowMotionStartTime;
+				bIsChangingMood = false;
+			}
+			if (!bCanLoseMood && Now >= KeepMoodEndTime) {
+				bCanLoseMood = true;
+			}
+		}
+
+		// The trigger is held the whole encounter, so every shot the step owes is fired like the weapon does
+		void FireWeapon() {
+			NextShotTime = MoodRules::GetFirstShotTime(NextShotTime, Now - Config.Step, Now);
+			while (NextShotTime <= Now) {
+				auto* Target = Enemies.FindByPredicate([](const FEnemy& Enemy) { return Enemy.Health > 0; });
+				if (Target == nullptr) {
+					return;
+				}
+
+				const auto ShotTime = NextShotTime;
+				NextShotTime += MoodRules::GetFireDelay(Config.Weapon, bIsChangingMood);
+				FireShot(*Target, ShotTime);
+			}
+		}
+
+		void FireShot(FEnemy& Target, double ShotTime) {
+			if (Target.FirstShotTime < 0.0) {
+				Target.FirstShotTime = ShotTime;
+			}
+			if (Stream.FRand() >= Config.Accuracy || Config.EnemyDistance > Config.Weapon.Range) {
+				return;
+			}
+
+			const auto Pattern = MoodRules::PickSpreadPattern(Config.Spread, Stream);
+			for (auto i = 0; i < Config.Weapon.PelletsPerShot; i++) {
+				// Pellet offsets at the enemy's distance, the shot being aimed at its center
+				const auto Index = Pattern * Config.Spread.Stride + i;
+				const auto RightOffset = Config.Spread.Right[Index] * Config.EnemyDistance;
+				const auto UpOffset = Config.Spread.Up[Index] * Config.EnemyDistance;
+				if (FMath::Abs(RightOffset) > Config.EnemyHalfWidth || FMath::Abs(UpOffset) > Config.EnemyHalfHeight) {
+					continue;
+				}
+
+				const auto Damage = MoodRules::ComputePelletDamage(Config.Weapon.DamagePerPellet, GetMoodTier().DamageMultiplier);
+				const auto Loss = MoodRules::ComputeHealthLoss(Damage, 1.f, Target.Health);
+				Target.Health -= Loss;
+				ChangeMoodValue(Loss);
+				bHasPendingDamageReset = true;
+
+				if (Target.Health <= 0) {
+					const auto TimeToKill = ShotTime - Target.FirstShotTime;
+					const auto Bucket = FMath::Min(FMath::FloorToInt32(TimeToKill / Config.TimeToKillBucketSize), Config.TimeToKillBuckets - 1);
+					Stats.TimeToKill[Bucket]++;
+					Stats.TotalTimeToKill += TimeToKill;
+					Stats.Kills++;
+					Target.RespawnTime = Now + Config.EnemyRespawnDelay;
+					break;
+				}
+			}
+		}
+
+		void AttackPlayer() {
+			for (auto& Enemy : Enemies) {
+				if (Enemy.Health <= 0) {
+					if (Now < Enemy.RespawnTime) {
+						continue;
+					}
+					Enemy = FEnemy();
+					Enemy.Health = Config.EnemyHealth.MaxHealth;
+					Enemy.TimeToAttack = Config.EnemyAttackInterval;
+				}
+
+				Enemy.TimeToAttack -= Config.Step;
+				if (Enemy.TimeToAttack > 0.f) {
+					continue;
+				}
+
+				Enemy.TimeToAttack += Config.EnemyAttackInterval;
+				if (Stream.FRand() < Config.EnemyAccuracy) {
+					const auto Loss = MoodRules::ComputeHealthLoss(Config.EnemyDamage, GetMoodTier().HealthLossMultiplier, PlayerHealth);
+					PlayerHealth -= Loss;
+					ChangeMoodValue(-Loss);
+				}
+			}
+		}
+
+		void RegenerateHealth() {
+			if (!GetMoodTier().bRegeneratesHealth) {
+				return;
+			}
+
+			TimeSinceHealthRegenerated += Config.Step;
+			if (TimeSinceHealthRegenerated >= Config.HealthGenerationDelay) {
+				PlayerHealth = MoodRules::ComputeHealing(Config.HealthGenerationAmount, PlayerHealth, Config.PlayerHealth.MaxHealth);
+				TimeSinceHealthRegenerated = 0.f;
+			}
+		}
+
+		void ChangeMoodValue(int32 Value) {
+			if (Value < 0) {
+				if (bIsChangingMood || !bCanLoseMood) {
+					return;
+				}
+				Value = MoodRules::ScaleMoodLoss(Value, Config.Mood.MoodLossWhenHit);
+			}
+
+			PendingMoodDelta += Value;
+		}
+
+		void ApplyPendingMoodChanges() {
+			if (!bIsChangingMood) {
+				const auto Elapsed = static_cast<float>(Now - FMath::Max(MoodTimestamp, MoodDecayStartTime));
+				MoodValue = MoodRules::DecayMoodMeter(Config.Tiers, MoodValue, MoodTier, Elapsed, Config.Mood.MaxMoodValue);
+			}
+			MoodTimestamp = Now;
+			UpdateMoodTier();
+
+			if (bHasPendingDamageReset) {
+				const auto IdleFrom = bIsChangingMood ? SlowMotionStartTime : Now;
+				MoodDecayStartTime = IdleFrom + Config.Mood.TimeIdleBeforeMoodLoss;
+				bHasPendingDamageReset = false;
+			}
+
+			const auto Delta = PendingMoodDelta;
+			PendingMoodDelta = 0;
+			if (Delta != 0) {
+				const auto PreviousMoodTier = MoodTier;
+				MoodValue = MoodRules::AddMoodValue(MoodValue, Delta, Config.Mood.MoodGainWhenDamaging, Config.Mood.MaxMoodValue);
+				if (UpdateMoodTier() && MoodTier > PreviousMoodTier) {
+					bCanLoseMood = false;
+					KeepMoodEndTime = Now + Config.Mood.TimeToKeepMood;
+				}
+			}
+		}
+
+		bool UpdateMoodTier() {
+			const auto PreviousMoodTier = MoodTier;
+			MoodTier = MoodRules::FindTierIndex(Config.Tiers, MoodValue);
+			if (MoodTier == PreviousMoodTier) {
+				return false;
+			}
+
+			if (MoodRules::ShouldTriggerSlowMotion(GetMoodTier(), PreviousMoodTier, MoodTier, Now, SlowMotionReadyTimes[MoodTier])) {
+				TriggerSlowMotion();
+				SlowMotionReadyTimes[MoodTier] = Now + Config.Mood.TimerSlowMotionReset;
+			}
+			MoodRules::ResetSlowMotionCooldowns(Config.Tiers, SlowMotionReadyTimes, MoodTier);
+			return true;
+		}
+
+		void TriggerSlowMotion() {
+			bCanLoseMood = false;
+			bIsChangingMood = true;
+			SlowMotionStartTime = Now;
+			SlowMotionEndTime = Now + Config.Mood.SlowMotionTime;
+			PlayerHealth = MoodRules::ComputeHealing(Config.SlowMotionHealing, PlayerHealth, Config.PlayerHealth.MaxHealth);
+			Stats.SlowMotions++;
+		}
+	};
+
+	MoodRules::FHealthRules GetDefaultHealthRules(const UClass* ActorClass) {
+		const auto* DefaultActor = ActorClass ? ActorClass->GetDefaultObject<AActor>() : nullptr;
+		const auto* Health = DefaultActor ? DefaultActor->FindComponentByClass<UMoodHealthComponent>() : nullptr;
+		if (Health == nullptr) {
+			UE_LOG(LogMoodBalance, Warning, TEXT("No health component on %s, using the default health"), *GetNameSafe(ActorClass));
+			return MoodRules::FHealthRules();
+		}
+		return Health->GetHealthRules();
+	}
+
+	template <typename T>
+	UClass* LoadClassParam(const FString& Params, const TCHAR* Name, const FString& DefaultPath) {
+		FString Path = DefaultPath;
+		FParse::Value(*Params, Name, Path);
+		if (Path.IsEmpty()) {
+			return T::StaticClass();
+		}
+
+		auto* Class = LoadClass<T>(nullptr, *Path);
+		if (Class == nullptr) {
+			UE_LOG(LogMoodBalance, Warning, TEXT("Couldn't load %s, using %s"), *Path, *T::StaticClass()->GetName());
+			return T::StaticClass();
+		}
+		return Class;
+	}
+}
+
+UMoodBalanceCommandlet::UMoodBalanceCommandlet() {
+	IsClient = false;
+	IsServer = false;
+	LogToConsole = true;
+	HelpDescription = TEXT("Simulates encounters against the combat and mood rules and prints balance histograms");
+	HelpUsage = TEXT("-run=MoodBalance [-Encounters=N] [-Seed=N] [-GameMode=Class] [-WeaponDefinition=Asset] [-Enemy=Class] [-Csv=File]");
+}
+
+int32 UMoodBalanceCommandlet::Main(const FString& Params) {
+	FBalanceConfig Config;
+
+	FString DefaultGameModePath;
+	GConfig->GetString(TEXT("/Script/EngineSettings.GameMapsSettings"), TEXT("GlobalDefaultGameMode"), DefaultGameModePath, GEngineIni);
+	const auto* GameModeClass = LoadClassParam<AMoodGameMode>(Params, TEXT("GameMode="), DefaultGameModePath);
+	const auto* GameMode = GameModeClass->GetDefaultObject<AMoodGameMode>();
+	Config.Mood = GameMode->GetMoodMeterRules();
+	Config.Tiers = TArray<FMoodTier>(GameMode->GetMoodTierTable()->GetTiers());
+	Config.PlayerHealth = GetDefaultHealthRules(GameMode->DefaultPawnClass);
+
+	// Weapons are authored as definition assets, a weapon component class only has the definition defaults
+	FString WeaponPath;
+	FParse::Value(*Params, TEXT("WeaponDefinition="), WeaponPath);
+	const auto* Weapon = WeaponPath.IsEmpty() ? nullptr : LoadObject<UMoodWeaponDefinition>(nullptr, *WeaponPath);
+	if (Weapon == nullptr) {
+		if (!WeaponPath.IsEmpty()) {
+			UE_LOG(LogMoodBalance, Warning, TEXT("Couldn't load %s, using the weapon definition defaults"), *WeaponPath);
+		}
+		Weapon = GetDefault<UMoodWeaponDefinition>();
+	}
+	Config.Weapon = Weapon->GetWeaponRules();
+	Config.EnemyHealth = GetDefaultHealthRules(LoadClassParam<AMoodEnemyCharacter>(Params, TEXT("Enemy="), FString()));
+
+	// Anything being tuned can be overridden without touching the assets
+	FParse::Value(*Params, TEXT("MoodGainWhenDamaging="), Config.Mood.MoodGainWhenDamaging);
+	FParse::Value(*Params, TEXT("MoodLossWhenHit="), Config.Mood.MoodLossWhenHit);
+	FParse::Value(*Params, TEXT("TimeIdleBeforeMoodLoss="), Config.Mood.TimeIdleBeforeMoodLoss);
+	FParse::Value(*Params, TEXT("TimeToKeepMood="), Config.Mood.TimeToKeepMood);
+	FParse::Value(*Params, TEXT("TimerSlowMotionReset="), Config.Mood.TimerSlowMotionReset);
+	FParse::Value(*Params, TEXT("SlowMotionTime="), Config.Mood.SlowMotionTime);
+	FParse::Value(*Params, TEXT("FireDelay="), Config.Weapon.FireDelay);
+	FParse::Value(*Params, TEXT("PelletsPerShot="), Config.Weapon.PelletsPerShot);
+	FParse::Value(*Params, TEXT("DamagePerPellet="), Config.Weapon.DamagePerPellet);
+	FParse::Value(*Params, TEXT("PlayerHealth="), Config.PlayerHealth.MaxHealth);
+	FParse::Value(*Params, TEXT("EnemyHealth="), Config.EnemyHealth.MaxHealth);
+
+	FParse::Value(*Params, TEXT("Encounters="), Config.Encounters);
+	FParse::Value(*Params, TEXT("Seed="), Config.Seed);
+	FParse::Value(*Params, TEXT("Duration="), Config.Duration);
+	FParse::Value(*Params, TEXT("Step="), Config.Step);
+	FParse::Value(*Params, TEXT("Accuracy="), Config.Accuracy);
+	FParse::Value(*Params, TEXT("EnemyDistance="), Config.EnemyDistance);
+	FParse::Value(*Params, TEXT("EnemyCount="), Config.EnemyCount);
+	FParse::Value(*Params, TEXT("EnemyDamage="), Config.EnemyDamage);
+	FParse::Value(*Params, TEXT("EnemyAttackInterval="), Config.EnemyAttackInterval);
+	FParse::Value(*Params, TEXT("EnemyAccuracy="), Config.EnemyAccuracy);
+
+	if (Config.Tiers.Num() == 0 || Config.Encounters <= 0 || Config.Step <= 0.f || Config.EnemyAttackInterval <= 0.f
+		|| Config.Weapon.FireDelay <= 0.f || Config.Weapon.SlowMotionFireRate <= 0.f) {
+		UE_LOG(LogMoodBalance, Error, TEXT("Nothing to simulate, check the tiers, encounters, step, attack interval and fire delays"));
+		return 1;
+	}
+
+	// Built after the overrides, a different pellet count only keeps the authored patterns that match it
+	const auto Pellets = Weapon->GetSpreadPatternPellets(Config.Weapon.PelletsPerShot);
+	Config.Spread = MoodRules::BuildSpreadTable(Pellets, Config.Weapon, FRandomStream(Config.Seed));
+
+	// Every encounter seeds its own stream, so the results don't depend on how the work is split up
+	const auto NumChunks = FMath::Min(Config.Encounters, FMath::Max(1, FTaskGraphInterface::Get().GetNumWorkerThreads()) * 8);
+	const auto EncountersPerChunk = FMath::DivideAndRoundUp(Config.Encounters, NumChunks);
+	TArray<FBalanceStats> ChunkStats;
+	ChunkStats.SetNum(NumChunks);
+
+	const auto StartTime = FPlatformTime::Seconds();
+	ParallelFor(NumChunks, [&Config, &ChunkStats, EncountersPerChunk](int32 ChunkIndex) {
+		auto& Stats = ChunkStats[ChunkIndex];
+		Stats.Init(Config);
+
+		const auto First = ChunkIndex * EncountersPerChunk;
+		const auto Last = FMath::Min(First + EncountersPerChunk, Config.Encounters);
+		for (auto EncounterIndex = First; EncounterIndex < Last; EncounterIndex++) {
+			const FRandomStream Stream(static_cast<int32>(HashCombine(Config.Seed, EncounterIndex)));
+			FEncounter(Config, Stream, Stats).Run();
+		}
+	});
+	const auto ElapsedTime = FPlatformTime::Seconds() - StartTime;
+
+	FBalanceStats Stats;
+	Stats.Init(Config);
+	for (const auto& Chunk : ChunkStats) {
+		Stats.Merge(Chunk);
+	}
+
+	UE_LOG(LogMoodBalance, Display, TEXT("%d encounters, %.0f simulated seconds in %.2f seconds"),
+		Config.Encounters, Stats.SimulatedTime, ElapsedTime);
+	UE_LOG(LogMoodBalance, Display, TEXT("Deaths: %.1f%% of encounters, slow motions: %.2f per minute"),
+		100.0 * Stats.Deaths / Config.Encounters, 60.0 * Stats.SlowMotions / FMath::Max(Stats.SimulatedTime, 1.0));
+
+	FString Csv = TEXT("Section,Key,Value\n");
+	const auto* MoodStateEnum = StaticEnum<EMoodState>();
+
+	UE_LOG(LogMoodBalance, Display, TEXT("Time in tier:"));
+	for (auto i = 0; i < Config.Tiers.Num(); i++) {
+		const auto Fraction = Stats.TimeInTier[i] / FMath::Max(Stats.SimulatedTime, 1.0);
+		const auto StateName = MoodStateEnum->GetNameStringByValue(Config.Tiers[i].State);
+		UE_LOG(LogMoodBalance, Display, TEXT("  %-12s %6.2f%% %s"), *StateName, 100.0 * Fraction,
+			*FString::ChrN(FMath::RoundToInt32(Fraction * 50.0), TEXT('#')));
+		Csv += FString::Printf(TEXT("TimeInTier,%s,%f\n"), *StateName, Fraction);
+	}
+
+	const auto BucketSize = Config.TimeToKillBucketSize;
+	UE_LOG(LogMoodBalance, Display, TEXT("Time to kill: %lld kills, average %.2fs, p50 %.2fs, p90 %.2fs, p99 %.2fs"),
+		Stats.Kills, Stats.Kills > 0 ? Stats.TotalTimeToKill / Stats.Kills : 0.0,
+		Stats.GetTimeToKillPercentile(0.5f, BucketSize), Stats.GetTimeToKillPercentile(0.9f, BucketSize),
+		Stats.GetTimeToKillPercentile(0.99f, BucketSize));
+	for (auto i = 0; i < Stats.TimeToKill.Num(); i++) {
+		const auto Fraction = Stats.Kills > 0 ? static_cast<double>(Stats.TimeToKill[i]) / Stats.Kills : 0.0;
+		if (Stats.TimeToKill[i] > 0) {
+			UE_LOG(LogMoodBalance, Display, TEXT("  %5.2fs %6.2f%% %s"), i * BucketSize, 100.0 * Fraction,
+				*FString::ChrN(FMath::RoundToInt32(Fraction * 50.0), TEXT('#')));
+		}
+		Csv += FString::Printf(TEXT("TimeToKill,%.2f,%f\n"), i * BucketSize, Fraction);
+	}
+
+	FString CsvPath;
+	if (FParse::Value(*Params, TEXT("Csv="), CsvPath)) {
+		if (!FFileHelper::SaveStringToFile(Csv, *CsvPath)) {
+			UE_LOG(LogMoodBalance, Error, TEXT("Couldn't write %s"), *CsvPath);
+			return 1;
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "MoodBalanceCommandlet.generated.h"
+
+/**
+ * Runs synthetic encounters against the combat and mood rules on every core and prints how long the
+ * player spends in each mood tier and how long it takes to kill an enemy. Tuning values are read from
+ * the game mode, weapon and health defaults and can be overridden on the command line.
+ *
+ * UnrealEditor-Cmd Mood.uproject -run=MoodBalance -Encounters=1000000 -MoodGainWhenDamaging=6 -Csv=Balance.csv
+ */
+UCLASS()
+class UMoodBalanceCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UMoodBalanceCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,58 @@
+#include "MoodDelegateBenchmark.h"
+
+#include "HAL/IConsoleManager.h"
+#include "Mood/MoodHealthComponent.h"
+#include "UObject/StrongObjectPtr.h"
+
+#if !UE_BUILD_SHIPPING
+
+namespace
+{
+	template <typename FBroadcastFunc>
+	double TimeBroadcasts(int32 Broadcasts, FBroadcastFunc&& Broadcast) {
+		const auto StartTime = FPlatformTime::Seconds();
+		for (auto i = 0; i < Broadcasts; i++) {
+			Broadcast(i);
+		}
+		return (FPlatformTime::Seconds() - StartTime) * 1e9 / Broadcasts;
+	}
+
+	// Mood.BenchmarkDelegates [Listeners] [Broadcasts]
+	void BenchmarkDelegates(const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar) {
+		const auto NumListeners = Args.IsValidIndex(0) ? FMath::Max(FCString::Atoi(*Args[0]), 0) : 8;
+		const auto Broadcasts = Args.IsValidIndex(1) ? FMath::Max(FCString::Atoi(*Args[1]), 1) : 100000;
+
+		FOnHurt DynamicDelegate;
+		FOnHurtNative NativeDelegate;
+		FOnHurt UnboundDynamicDelegate;
+
+		TArray<TStrongObjectPtr<UMoodDelegateBenchmarkListener>> Listeners;
+		for (auto i = 0; i < NumListeners; i++) {
+			auto& Listener = Listeners.Emplace_GetRef(NewObject<UMoodDelegateBenchmarkListener>());
+			DynamicDelegate.AddDynamic(Listener.Get(), &UMoodDelegateBenchmarkListener::OnHurt);
+			NativeDelegate.AddUObject(Listener.Get(), &UMoodDelegateBenchmarkListener::OnHurt);
+		}
+
+		const auto DynamicTime = TimeBroadcasts(Broadcasts, [&](int32 i) { DynamicDelegate.Broadcast(1, i); });
+		const auto NativeTime = TimeBroadcasts(Broadcasts, [&](int32 i) { NativeDelegate.Broadcast(1, i); });
+		const auto UnboundTime = TimeBroadcasts(Broadcasts, [&](int32 i) { UnboundDynamicDelegate.Broadcast(1, i); });
+		const auto GuardedTime = TimeBroadcasts(Broadcasts, [&](int32 i) {
+			if (UnboundDynamicDelegate.IsBound()) {
+				UnboundDynamicDelegate.Broadcast(1, i);
+			}
+		});
+
+		Ar.Logf(TEXT("%d broadcasts to %d listeners, nanoseconds per broadcast:"), Broadcasts, NumListeners);
+		Ar.Logf(TEXT("  Dynamic:                  %8.1f"), DynamicTime);
+		Ar.Logf(TEXT("  Native:                   %8.1f"), NativeTime);
+		Ar.Logf(TEXT("  Dynamic, nothing bound:   %8.1f"), UnboundTime);
+		Ar.Logf(TEXT("  IsBound guard, no listen: %8.1f"), GuardedTime);
+	}
+
+	FAutoConsoleCommand BenchmarkDelegatesCommand(
+		TEXT("Mood.BenchmarkDelegates"),
+		TEXT("Times dynamic against native multicast broadcasts. Args: [Listeners] [Broadcasts]"),
+		FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateStatic(&BenchmarkDelegates));
+}
+
+#endif
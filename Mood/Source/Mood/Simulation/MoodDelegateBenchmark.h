@@ -0,0 +1,17 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MoodDelegateBenchmark.generated.h"
+
+// Listener for the Mood.BenchmarkDelegates console command, bound to both kinds of delegates
+UCLASS(Transient)
+class UMoodDelegateBenchmarkListener : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	UFUNCTION()
+	void OnHurt(int Amount, int NewHealth) { TotalAmount += Amount; }
+
+	int64 TotalAmount = 0;
+};
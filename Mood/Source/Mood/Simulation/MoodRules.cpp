@@ -0,0 +1,168 @@
+#include "MoodRules.h"
+
+namespace MoodRules
+{
+	int32 FindTierIndex(TConstArrayView<FMoodTier> Tiers, float MoodValue) {
+		auto TierIndex = 0;
+		while (TierIndex + 1 < Tiers.Num() && Tiers[TierIndex + 1].Threshold <= MoodValue) {
+			TierIndex++;
+		}
+		return TierIndex;
+	}
+
+	float DecayMoodMeter(TConstArrayView<FMoodTier> Tiers, float MoodValue, int32 TierIndex, float Elapsed, int32 MaxMoodValue) {
+		// Decay is linear within a tier, so walk down one tier at a time until the elapsed time is used up
+		while (Elapsed > 0.f) {
+			const auto& Tier = Tiers[TierIndex];
+			const auto TimeToThreshold = Tier.DecayRate > 0.f ? (MoodValue - Tier.Threshold) / Tier.DecayRate : Elapsed;
+			if (Elapsed < TimeToThreshold) {
+				MoodValue -= Elapsed * Tier.DecayRate;
+				break;
+			}
+
+			Elapsed -= TimeToThreshold;
+			if (TierIndex == 0) {
+				MoodValue = 0.f;
+				break;
+			}
+
+			// Just below the threshold, the tier below owns the meter from here on
+			MoodValue = Tier.Threshold - UE_KINDA_SMALL_NUMBER;
+			TierIndex--;
+		}
+
+		return FMath::Clamp(MoodValue, 0.f, static_cast<float>(MaxMoodValue));
+	}
+
+	int32 ScaleMoodLoss(int32 Value, float MoodLossWhenHit) {
+		return static_cast<int32>(Value * MoodLossWhenHit);
+	}
+
+	float AddMoodValue(float MoodValue, int32 Delta, float MoodGainWhenDamaging, int32 MaxMoodValue) {
+		return FMath::Clamp(MoodValue + Delta * MoodGainWhenDamaging, 0.f, static_cast<float>(MaxMoodValue));
+	}
+
+	bool ShouldTriggerSlowMotion(const FMoodTier& Tier, int32 PreviousTier, int32 NewTier, double Now, double ReadyTime) {
+		return Tier.bTriggersSlowMotion
+			&& (!Tier.bSlowMotionOnlyWhenRising || NewTier > PreviousTier)
+			&& Now >= ReadyTime;
+	}
+
+	void ResetSlowMotionCooldowns(TConstArrayView<FMoodTier> Tiers, TArrayView<double> ReadyTimes, int32 NewTier) {
+		for (auto i = NewTier + 1; i < ReadyTimes.Num() && i < Tiers.Num(); i++) {
+			if (i - NewTier >= Tiers[i].SlowMotionCooldownResetDepth) {
+				ReadyTimes[i] = 0.0;
+			}
+		}
+	}
+
+	int32 ComputeHealthLoss(int32 Amount, float HealthLossPercent, int32 CurrentHealth) {
+		const auto Loss = static_cast<int32>(FMath::Abs(Amount) * HealthLossPercent);
+		return FMath::Clamp(Loss, 0, CurrentHealth);
+	}
+
+	int32 ComputeHealing(int32 Amount, int32 CurrentHealth, int32 MaxHealth) {
+		return FMath::Min(CurrentHealth + FMath::Abs(Amount), MaxHealth);
+	}
+
+	bool CanBeExecuted(int32 CurrentHealth, int32 MaxHealth) {
+		return CurrentHealth < MaxHealth / 4;
+	}
+
+	float GetFireDelay(const FWeaponRules& Weapon, bool bIsInSlowMotion) {
+		return bIsInSlowMotion ? Weapon.SlowMotionFireRate : Weapon.FireDelay;
+	}
+
+	double GetFirstShotTime(double NextShotTime, double FrameStart, double Now) {
+		return NextShotTime < FrameStart ? Now : NextShotTime;
+	}
+
+	int32 ComputePelletDamage(int32 DamagePerPellet, float DamageMultiplier) {
+		return FMath::FloorToInt32(DamagePerPellet * DamageMultiplier);
+	}
+
+	static void GenerateSpreadPattern(TArray<FVector2f, TInlineAllocator<16>>& Pellets, int32 Count,
+	                                  const FVector2f& MaxSpread, const FRandomStream& Stream) {
+		constexpr auto Candidates = 16;
+
+		// Each pellet is the candidate furthest away from the ones already placed, measured on the actual spread
+		for (auto i = 0; i < Count; i++) {
+			FVector2f Best = FVector2f::ZeroVector;
+			auto BestDistance = -1.f;
+			for (auto c = 0; c < Candidates; c++) {
+				const FVector2f Candidate(Stream.FRandRange(-1.f, 1.f), Stream.FRandRange(-1.f, 1.f));
+				auto Distance = MAX_flt;
+				for (const auto& Pellet : Pellets) {
+					Distance = FMath::Min(Distance, ((Candidate - Pellet) * MaxSpread).SizeSquared());
+				}
+				if (Distance > BestDistance) {
+					Best = Candidate;
+					BestDistance = Distance;
+				}
+			}
+			Pellets.Add(Best);
+		}
+	}
+
+	FSpreadTable BuildSpreadTable(TConstArrayView<FVector2f> AuthoredPellets, const FWeaponRules& Weapon,
+	                              const FRandomStream& Stream) {
+		FSpreadTable Table;
+		Table.PelletsPerShot = FMath::Max(Weapon.PelletsPerShot, 0);
+		Table.Stride = Align(Table.PelletsPerShot, 4);
+		const auto NumAuthored = Table.PelletsPerShot > 0 ? AuthoredPellets.Num() / Table.PelletsPerShot : 0;
+		Table.NumPatterns = NumAuthored > 0 ? NumAuthored : FMath::Max(Weapon.GeneratedSpreadPatterns, 1);
+		Table.Right.SetNumZeroed(Table.NumPatterns * Table.Stride);
+		Table.Up.SetNumZeroed(Table.NumPatterns * Table.Stride);
+
+		TArray<FVector2f, TInlineAllocator<16>> Pellets;
+		for (auto Pattern = 0; Pattern < Table.NumPatterns; Pattern++) {
+			Pellets.Reset();
+			if (NumAuthored > 0) {
+				Pellets.Append(AuthoredPellets.Slice(Pattern * Table.PelletsPerShot, Table.PelletsPerShot));
+			}
+			else {
+				GenerateSpreadPattern(Pellets, Table.PelletsPerShot, Weapon.MaxSpread, Stream);
+			}
+
+			for (auto i = 0; i < Table.PelletsPerShot; i++) {
+				Table.Right[Pattern * Table.Stride + i] = Pellets[i].X * Weapon.MaxSpread.X;
+				Table.Up[Pattern * Table.Stride + i] = Pellets[i].Y * Weapon.MaxSpread.Y;
+			}
+		}
+		return Table;
+	}
+
+	int32 PickSpreadPattern(const FSpreadTable& Table, const FRandomStream& Stream) {
+		return Stream.RandHelper(Table.NumPatterns);
+	}
+
+	void TransformSpread(const FSpreadTable& Table, int32 Pattern, const FVector& Origin, const FQuat& Rotation,
+	                     double Range, TArrayView<FVector> OutEnds) {
+		check(OutEnds.Num() >= Table.PelletsPerShot);
+
+		// End = Origin + (Forward + Right * RightOffset + Up * UpOffset) * Range, one axis at a time
+		const auto Base = Origin + Rotation.GetForwardVector() * Range;
+		const auto Right = Rotation.GetRightVector() * Range;
+		const auto Up = Rotation.GetUpVector() * Range;
+		const VectorRegister4Double BaseAxes[3] = {VectorSetFloat1(Base.X), VectorSetFloat1(Base.Y), VectorSetFloat1(Base.Z)};
+		const VectorRegister4Double RightAxes[3] = {VectorSetFloat1(Right.X), VectorSetFloat1(Right.Y), VectorSetFloat1(Right.Z)};
+		const VectorRegister4Double UpAxes[3] = {VectorSetFloat1(Up.X), VectorSetFloat1(Up.Y), VectorSetFloat1(Up.Z)};
+
+		const auto* RightOffsets = Table.Right.GetData() + Pattern * Table.Stride;
+		const auto* UpOffsets = Table.Up.GetData() + Pattern * Table.Stride;
+		double Ends[3][4];
+		for (auto i = 0; i < Table.PelletsPerShot; i += 4) {
+			const auto RightOffset = VectorLoad(RightOffsets + i);
+			const auto UpOffset = VectorLoad(UpOffsets + i);
+			for (auto Axis = 0; Axis < 3; Axis++) {
+				const auto End = VectorMultiplyAdd(UpOffset, UpAxes[Axis], VectorMultiplyAdd(RightOffset, RightAxes[Axis], BaseAxes[Axis]));
+				VectorStore(End, Ends[Axis]);
+			}
+
+			const auto Count = FMath::Min(4, Table.PelletsPerShot - i);
+			for (auto j = 0; j < Count; j++) {
+				OutEnds[i + j] = FVector(Ends[0][j], Ends[1][j], Ends[2][j]);
+			}
+		}
+	}
+}
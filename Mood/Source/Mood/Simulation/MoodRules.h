@@ -0,0 +1,84 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Mood/MoodTierTable.h"
+
+/**
+ * The combat and mood rules of the game as plain functions on plain data. The game mode, health and
+ * weapon components call these with their own state, and the balance simulator calls them without
+ * a world, so both always agree on the numbers.
+ */
+namespace MoodRules
+{
+	struct FMoodMeterRules
+	{
+		float MoodLossWhenHit = 1.f;
+		float MoodGainWhenDamaging = 5.f;
+		float TimeIdleBeforeMoodLoss = 2.f;
+		float TimeToKeepMood = 3.f;
+		float TimerSlowMotionReset = 30.f;
+		float SlowMotionTime = 1.f;
+		int32 MaxMoodValue = 1000;
+	};
+
+	struct FHealthRules
+	{
+		int32 MaxHealth = 100;
+	};
+
+	struct FWeaponRules
+	{
+		float FireDelay = 0.25f;
+		float SlowMotionFireRate = 0.1f;
+		float Range = 10000.f;
+		int32 PelletsPerShot = 5;
+		int32 DamagePerPellet = 5;
+		FVector2f MaxSpread = {0, 0};
+		// Used when the weapon has no authored spread patterns
+		int32 GeneratedSpreadPatterns = 16;
+	};
+
+	// Pellet offsets of every spread pattern along the muzzle's right and up axes, scaled by the max
+	// spread. Each pattern is padded to a multiple of four pellets and each axis has its own array, so
+	// TransformSpread places four pellets at a time
+	struct FSpreadTable
+	{
+		int32 PelletsPerShot = 0;
+		int32 Stride = 0;
+		int32 NumPatterns = 0;
+		TArray<double> Right;
+		TArray<double> Up;
+	};
+
+	// Tiers must be sorted by threshold with the first one starting at zero
+	int32 FindTierIndex(TConstArrayView<FMoodTier> Tiers, float MoodValue);
+	// Meter value after decaying for Elapsed seconds, walking down through the tiers it passes
+	float DecayMoodMeter(TConstArrayView<FMoodTier> Tiers, float MoodValue, int32 TierIndex, float Elapsed, int32 MaxMoodValue);
+	int32 ScaleMoodLoss(int32 Value, float MoodLossWhenHit);
+	float AddMoodValue(float MoodValue, int32 Delta, float MoodGainWhenDamaging, int32 MaxMoodValue);
+
+	bool ShouldTriggerSlowMotion(const FMoodTier& Tier, int32 PreviousTier, int32 NewTier, double Now, double ReadyTime);
+	// Falling far enough below a tier makes its slow motion available again
+	void ResetSlowMotionCooldowns(TConstArrayView<FMoodTier> Tiers, TArrayView<double> ReadyTimes, int32 NewTier);
+
+	// Health actually lost from a hit, never more than what is left
+	int32 ComputeHealthLoss(int32 Amount, float HealthLossPercent, int32 CurrentHealth);
+	// Health after healing, capped at max health
+	int32 ComputeHealing(int32 Amount, int32 CurrentHealth, int32 MaxHealth);
+	bool CanBeExecuted(int32 CurrentHealth, int32 MaxHealth);
+
+	float GetFireDelay(const FWeaponRules& Weapon, bool bIsInSlowMotion);
+	// When a held trigger fires its first shot of the frame from FrameStart to Now. A weapon that was
+	// ready before the frame fires right away, instead of catching up on time nobody was shooting
+	double GetFirstShotTime(double NextShotTime, double FrameStart, double Now);
+	int32 ComputePelletDamage(int32 DamagePerPellet, float DamageMultiplier);
+
+	// Authored pellets are from -1 to 1 of the max spread, PelletsPerShot of them per pattern. Without
+	// any, patterns are generated with best-candidate sampling so the pellets don't clump together
+	FSpreadTable BuildSpreadTable(TConstArrayView<FVector2f> AuthoredPellets, const FWeaponRules& Weapon,
+	                              const FRandomStream& Stream);
+	int32 PickSpreadPattern(const FSpreadTable& Table, const FRandomStream& Stream);
+	// Trace ends of every pellet in the pattern, Range out along the muzzle's forward axis
+	void TransformSpread(const FSpreadTable& Table, int32 Pattern, const FVector& Origin, const FQuat& Rotation,
+	                     double Range, TArrayView<FVector> OutEnds);
+}
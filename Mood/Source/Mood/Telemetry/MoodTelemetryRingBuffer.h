@@ -0,0 +1,49 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include <atomic>
+
+/**
+ * Fixed size queue for exactly one producer thread and one consumer thread. Neither side takes a lock,
+ * the producer only writes the head and the consumer only writes the tail.
+ */
+template <typename T>
+class TMoodSpscRingBuffer
+{
+public:
+	explicit TMoodSpscRingBuffer(uint32 Capacity)
+		: Mask(FMath::RoundUpToPowerOfTwo(FMath::Max(Capacity, 2u)) - 1) {
+		Items.SetNum(Mask + 1);
+	}
+
+	// Producer only. Returns false without blocking when the consumer has fallen behind
+	bool Push(const T& Item) {
+		const auto Head = HeadIndex.load(std::memory_order_relaxed);
+		if (Head - TailIndex.load(std::memory_order_acquire) > Mask) {
+			return false;
+		}
+
+		Items[Head & Mask] = Item;
+		HeadIndex.store(Head + 1, std::memory_order_release);
+		return true;
+	}
+
+	// Consumer only
+	bool Pop(T& OutItem) {
+		const auto Tail = TailIndex.load(std::memory_order_relaxed);
+		if (Tail == HeadIndex.load(std::memory_order_acquire)) {
+			return false;
+		}
+
+		OutItem = Items[Tail & Mask];
+		TailIndex.store(Tail + 1, std::memory_order_release);
+		return true;
+	}
+
+private:
+	const uint32 Mask;
+	TArray<T> Items;
+	// Kept on separate cache lines so the two threads don't keep invalidating each other
+	alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<uint32> HeadIndex{0};
+	alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<uint32> TailIndex{0};
+};
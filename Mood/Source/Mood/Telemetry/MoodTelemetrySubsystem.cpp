@@ -0,0 +1,222 @@
+#include "MoodTelemetrySubsystem.h"
+
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "HAL/FileManager.h"
+#include "HAL/Runnable.h"
+#include "HAL/RunnableThread.h"
+#include "Misc/Paths.h"
+#include "MoodTelemetryRingBuffer.h"
+
+// Drains the event queue into the session file on its own thread
+class FMoodTelemetryWriter : public FRunnable
+{
+public:
+	explicit FMoodTelemetryWriter(FArchive* InFile)
+		: Queue(QueueCapacity), File(InFile) {
+		WakeEvent = FPlatformProcess::GetSynchEventFromPool();
+		Thread = FRunnableThread::Create(this, TEXT("MoodTelemetryWriter"), 0, TPri_BelowNormal);
+	}
+
+	virtual ~FMoodTelemetryWriter() override {
+		Stop();
+		if (Thread != nullptr) {
+			Thread->WaitForCompletion();
+			delete Thread;
+		}
+		FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+
+		Drain();
+		File->Close();
+	}
+
+	// Game thread only
+	bool Push(const FMoodTelemetryEvent& Event) {
+		return Queue.Push(Event);
+	}
+
+	virtual uint32 Run() override {
+		while (!bIsStopping.load(std::memory_order_relaxed)) {
+			WakeEvent->Wait(FlushIntervalMs);
+			Drain();
+		}
+		return 0;
+	}
+
+	virtual void Stop() override {
+		bIsStopping.store(true, std::memory_order_relaxed);
+		WakeEvent->Trigger();
+	}
+
+private:
+	static constexpr uint32 QueueCapacity = 1 << 16;
+	static constexpr uint32 FlushIntervalMs = 100;
+
+	TMoodSpscRingBuffer<FMoodTelemetryEvent> Queue;
+	TUniquePtr<FArchive> File;
+	FEvent* WakeEvent = nullptr;
+	FRunnableThread* Thread = nullptr;
+	std::atomic<bool> bIsStopping{false};
+
+	void Drain() {
+		FMoodTelemetryEvent Event;
+		auto bHasWritten = false;
+		while (Queue.Pop(Event)) {
+			Write(Event);
+			bHasWritten = true;
+		}
+
+		// Flushed every time so a crashed soak session still leaves a readable file
+		if (bHasWritten) {
+			File->Flush();
+		}
+	}
+
+	void Write(FMoodTelemetryEvent& Event) {
+		auto Type = static_cast<uint8>(Event.Type);
+		*File << Type << Event.Time << Event.Frame << Event.SourceId;
+
+		if (Event.Type == EMoodTelemetryEventType::ObjectName) {
+			auto ObjectName = Event.ObjectName.ToString();
+			auto ClassName = Event.ClassName.ToString();
+			*File << ObjectName << ClassName;
+		}
+		else {
+			*File << Event.TargetId << Event.ValueA << Event.ValueB;
+		}
+	}
+};
+
+UMoodTelemetrySubsystem* UMoodTelemetrySubsystem::Get(const UObject* WorldContextObject) {
+	const auto* World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull);
+	const auto* GameInstance = World ? World->GetGameInstance() : nullptr;
+	return GameInstance ? GameInstance->GetSubsystem<UMoodTelemetrySubsystem>() : nullptr;
+}
+
+bool UMoodTelemetrySubsystem::ShouldCreateSubsystem(UObject* Outer) const {
+	return FPlatformProcess::SupportsMultithreading() && !FParse::Param(FCommandLine::Get(), TEXT("NoMoodTelemetry"));
+}
+
+void UMoodTelemetrySubsystem::Initialize(FSubsystemCollectionBase& Collection) {
+	Super::Initialize(Collection);
+
+	const auto FileName = FString::Printf(TEXT("Session_%s.mtel"), *FDateTime::Now().ToString());
+	const auto Path = FPaths::ProjectSavedDir() / TEXT("Telemetry") / FileName;
+	auto* File = IFileManager::Get().CreateFileWriter(*Path);
+	if (File == nullptr) {
+		UE_LOG(LogTemp, Error, TEXT("UMoodTelemetrySubsystem: Couldn't create %s"), *Path);
+		return;
+	}
+
+	auto Magic = FileMagic;
+	auto Version = FileVersion;
+	auto StartTicks = FDateTime::UtcNow().GetTicks();
+	*File << Magic << Version << StartTicks;
+
+	Writer = new FMoodTelemetryWriter(File);
+}
+
+void UMoodTelemetrySubsystem::Deinitialize() {
+	// Joins the writer thread after it has written everything left in the queue
+	delete Writer;
+	Writer = nullptr;
+	NamedObjects.Empty();
+
+	Super::Deinitialize();
+}
+
+void UMoodTelemetrySubsystem::RecordMoodTierChanged(int32 PreviousTier, int32 NewTier) {
+	Record(EMoodTelemetryEventType::MoodTierChanged, nullptr, nullptr, PreviousTier, NewTier);
+}
+
+void UMoodTelemetrySubsystem::RecordSlowMotionTriggered(int32 Tier) {
+	Record(EMoodTelemetryEventType::SlowMotionTriggered, nullptr, nullptr, Tier, 0);
+}
+
+void UMoodTelemetrySubsystem::RecordExecution(const AActor* Executioner, const AActor* Executee, int32 Damage) {
+	Record(EMoodTelemetryEventType::Execution, Executioner, Executee, Damage, 0);
+}
+
+void UMoodTelemetrySubsystem::RecordSpawnerWave(const AActor* Spawner, int32 Wave, int32 EnemyCount) {
+	Record(EMoodTelemetryEventType::SpawnerWave, Spawner, nullptr, Wave, EnemyCount);
+}
+
+void UMoodTelemetrySubsystem::RecordPlayerDeath(const AActor* Player) {
+	Record(EMoodTelemetryEventType::PlayerDeath, Player, nullptr, 0, 0);
+}
+
+void UMoodTelemetrySubsystem::RecordHurt(const AActor* Attacker, const AActor* Victim, int32 Amount, int32 NewHealth) {
+	Record(EMoodTelemetryEventType::Hurt, Attacker, Victim, Amount, NewHealth);
+}
+
+void UMoodTelemetrySubsystem::RecordWeaponFired(const UObject* Weapon, const AActor* Shooter, int32 Pellets) {
+	Record(EMoodTelemetryEventType::WeaponFired, Shooter, Weapon, Pellets, 0);
+}
+
+void UMoodTelemetrySubsystem::RecordWeaponSelected(const UObject* Weapon, const AActor* Owner) {
+	Record(EMoodTelemetryEventType::WeaponSelected, Owner, Weapon, 0, 0);
+}
+
+void UMoodTelemetrySubsystem::Record(EMoodTelemetryEventType Type, const UObject* Source, const UObject* Target,
+                                     int32 ValueA, int32 ValueB) {
+	if (Writer == nullptr) {
+		return;
+	}
+	checkSlow(IsInGameThread());
+
+	FMoodTelemetryEvent Event;
+	Event.Type = Type;
+	Event.SourceId = GetObjectId(Source);
+	Event.TargetId = GetObjectId(Target);
+	Event.ValueA = ValueA;
+	Event.ValueB = ValueB;
+	Push(Event);
+}
+
+uint32 UMoodTelemetrySubsystem::GetObjectId(const UObject* Object) {
+	if (Object == nullptr) {
+		return 0;
+	}
+
+	const auto Id = Object->GetUniqueID();
+	const auto* NamedObject = NamedObjects.Find(Id);
+	if (NamedObject == nullptr || NamedObject->Get() != Object) {
+		FMoodTelemetryEvent Event;
+		Event.Type = EMoodTelemetryEventType::ObjectName;
+		Event.SourceId = Id;
+		Event.ObjectName = Object->GetFName();
+		Event.ClassName = Object->GetClass()->GetFName();
+		// If the name got dropped, try again the next time the object shows up
+		if (Push(Event)) {
+			NamedObjects.Add(Id, Object);
+		}
+	}
+	return Id;
+}
+
+bool UMoodTelemetrySubsystem::Push(const FMoodTelemetryEvent& Event) {
+	const auto* World = GetWorld();
+	auto TimedEvent = Event;
+	TimedEvent.Time = World ? World->GetTimeSeconds() : 0.0;
+	TimedEvent.Frame = static_cast<uint32>(GFrameCounter);
+
+	if (DroppedEvents > 0) {
+		FMoodTelemetryEvent DroppedEvent;
+		DroppedEvent.Type = EMoodTelemetryEventType::Dropped;
+		DroppedEvent.Time = TimedEvent.Time;
+		DroppedEvent.Frame = TimedEvent.Frame;
+		DroppedEvent.ValueA = DroppedEvents;
+		if (!Writer->Push(DroppedEvent)) {
+			DroppedEvents++;
+			return false;
+		}
+		DroppedEvents = 0;
+	}
+
+	if (!Writer->Push(TimedEvent)) {
+		DroppedEvents++;
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "MoodTelemetrySubsystem.generated.h"
+
+class FMoodTelemetryWriter;
+
+enum class EMoodTelemetryEventType : uint8
+{
+	// Names an object id the first time it shows up in the session
+	ObjectName,
+	// Number of events lost because the writer fell behind
+	Dropped,
+	MoodTierChanged,
+	SlowMotionTriggered,
+	Execution,
+	SpawnerWave,
+	PlayerDeath,
+	Hurt,
+	WeaponFired,
+	WeaponSelected
+};
+
+struct FMoodTelemetryEvent
+{
+	EMoodTelemetryEventType Type = EMoodTelemetryEventType::ObjectName;
+	double Time = 0.0;
+	uint32 Frame = 0;
+	uint32 SourceId = 0;
+	uint32 TargetId = 0;
+	int32 ValueA = 0;
+	int32 ValueB = 0;
+	// Only set for ObjectName, resolved to text on the writer thread
+	FName ObjectName;
+	FName ClassName;
+};
+
+/**
+ * Collects gameplay events for the whole session into a binary file under Saved/Telemetry. Recording
+ * only copies the event into a lock-free queue, a background thread does the file writing. Pass
+ * -NoMoodTelemetry to turn it off.
+ */
+UCLASS()
+class UMoodTelemetrySubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	static constexpr uint32 FileMagic = 0x4C45544D; // "MTEL"
+	static constexpr uint16 FileVersion = 1;
+
+	static UMoodTelemetrySubsystem* Get(const UObject* WorldContextObject);
+
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	void RecordMoodTierChanged(int32 PreviousTier, int32 NewTier);
+	void RecordSlowMotionTriggered(int32 Tier);
+	void RecordExecution(const AActor* Executioner, const AActor* Executee, int32 Damage);
+	void RecordSpawnerWave(const AActor* Spawner, int32 Wave, int32 EnemyCount);
+	void RecordPlayerDeath(const AActor* Player);
+	void RecordHurt(const AActor* Attacker, const AActor* Victim, int32 Amount, int32 NewHealth);
+	void RecordWeaponFired(const UObject* Weapon, const AActor* Shooter, int32 Pellets);
+	void RecordWeaponSelected(const UObject* Weapon, const AActor* Owner);
+
+private:
+	// Owned here, a raw pointer so the writer can stay private to the cpp
+	FMoodTelemetryWriter* Writer = nullptr;
+	// Objects that already have a name event in the file, to notice when an id gets reused
+	TMap<uint32, TWeakObjectPtr<const UObject>> NamedObjects;
+	int32 DroppedEvents = 0;
+
+	void Record(EMoodTelemetryEventType Type, const UObject* Source, const UObject* Target, int32 ValueA, int32 ValueB);
+	uint32 GetObjectId(const UObject* Object);
+	bool Push(const FMoodTelemetryEvent& Event);
+};
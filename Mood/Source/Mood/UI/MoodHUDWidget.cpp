@@ -13,6 +13,7 @@
 #include "Components/RadialSlider.h"
 #include "Components/ProgressBar.h"
 #include "../MoodGameMode.h"
+#include "../MoodTimeDilationSubsystem.h"
 #include "Components/TextBlock.h"
 #include "Components/Image.h"
 #include "Kismet/KismetMathLibrary.h"
@@ -39,7 +40,7 @@ void UMoodHUDWidget::NativeTick(const FGeometry& MyGeometry, float InDeltaTime)
 
 void UMoodHUDWidget::GetHealthComponent(ACharacter* PlayerPass)
 {
-	HealthComponent = PlayerPass->FindComponentByClass<UMoodHealthComponent>();
+	HealthComponent = UMoodHealthComponent::Get(PlayerPass);
 }
 
 void UMoodHUDWidget::GetWeaponSlotComponent(ACharacter* PlayerPass)
@@ -97,7 +98,7 @@ void UMoodHUDWidget::UpdateAmmoWidget()
 void UMoodHUDWidget::UpdateMoodMeterWidget(const FGeometry& MyGeometry, float InDeltaTime)
 {
 	MoodMeterValue = GameMode->GetMoodMeterValue();
-	MoodMeterValue = FMath::Clamp(MoodMeterValue, 0.f, 666.f);
+	MoodMeterValue = FMath::Clamp(MoodMeterValue, 0.f, static_cast<float>(GameMode->GetMoodTierTable()->GetTopThreshold()));
 	MoodMeterWidget->MoodMeterNumber->SetText(FText::FromString(FString::FromInt(FMath::FloorToInt32(MoodMeterValue))));
 
 	UpdateMoodMeterBars(MyGeometry, InDeltaTime, MoodMeterValue);
@@ -105,26 +106,24 @@ void UMoodHUDWidget::UpdateMoodMeterWidget(const FGeometry& MyGeometry, float In
 
 void UMoodHUDWidget::UpdateMoodMeterBars(const FGeometry& MyGeometry, float InDeltaTime, float MoodMeterValueToText)
 {
-	if (MoodMeterValueToText >= 0 && MoodMeterValueToText <= 222)
+	// Each circle fills up between the thresholds of two neighbouring tiers
+	URadialSlider* const Circles[] = {
+		MoodMeterWidget->MoodMeterInnerCircle,
+		MoodMeterWidget->MoodMeterMiddleCircle,
+		MoodMeterWidget->MoodMeterOuterCircle
+	};
+	const auto* TierTable = GameMode->GetMoodTierTable();
+	for (int32 i = 0; i < static_cast<int32>(UE_ARRAY_COUNT(Circles)); i++)
 	{
-		MoodMeterWidget->MoodMeterMiddleCircle->SetValue(0.f);
-		MoodMeterWidget->MoodMeterOuterCircle->SetValue(0.f);
-		MoodMeterValueToText = UKismetMathLibrary::NormalizeToRange(MoodMeterValueToText, 0, 222);
-		MoodMeterWidget->MoodMeterInnerCircle->SetValue(MoodMeterValueToText);
-	}
-	else if (MoodMeterValueToText >= 223 && MoodMeterValueToText <= 444)
-	{
-		MoodMeterWidget->MoodMeterInnerCircle->SetValue(1.f);
-		MoodMeterWidget->MoodMeterOuterCircle->SetValue(0.f);
-		MoodMeterValueToText = UKismetMathLibrary::NormalizeToRange(MoodMeterValueToText, 223, 444);
-		MoodMeterWidget->MoodMeterMiddleCircle->SetValue(MoodMeterValueToText);
-	}
-	else if (MoodMeterValueToText >= 445 && MoodMeterValueToText <= 666)
-	{
-		MoodMeterWidget->MoodMeterInnerCircle->SetValue(1.f);
-		MoodMeterWidget->MoodMeterMiddleCircle->SetValue(1.f);
-		MoodMeterValueToText = UKismetMathLibrary::NormalizeToRange(MoodMeterValueToText, 445, 666);
-		MoodMeterWidget->MoodMeterOuterCircle->SetValue(MoodMeterValueToText);
+		if (i + 1 >= TierTable->NumTiers())
+		{
+			Circles[i]->SetValue(0.f);
+			continue;
+		}
+
+		const auto CircleValue = UKismetMathLibrary::NormalizeToRange(MoodMeterValueToText,
+			TierTable->GetTier(i).Threshold, TierTable->GetTier(i + 1).Threshold);
+		Circles[i]->SetValue(FMath::Clamp(CircleValue, 0.f, 1.f));
 	}
 }
 
@@ -135,23 +134,8 @@ void UMoodHUDWidget::UpdateCrosshair(UMoodWeaponComponent* WeaponToPass)
 
 void UMoodHUDWidget::UpdateHUDTint()
 {
-	switch (GameMode->GetMoodState())
-	{
-	case EMoodState::Ems_NoMood:
-		SetTint(TintColorStage0, TintColorStage0);
-		break;
-	case EMoodState::Ems_Mood222:
-		SetTint(TintColorStage1, TintColorStage1);
-		break;
-	case EMoodState::Ems_Mood444:
-		SetTint(TintColorStage2, TintColorStage1);
-		break;
-	case EMoodState::Ems_Mood666:
-		SetTint(TintColorStage3, TintColorStage3);
-		break;
-	default:
-		break;
-	}
+	const auto& MoodTier = GameMode->GetMoodTier();
+	SetTint(MoodTier.Tint, MoodTier.FaceTint);
 }
 
 void UMoodHUDWidget::SetTint(FLinearColor Color, FLinearColor FaceColor)
@@ -208,7 +192,7 @@ void UMoodHUDWidget::UpdateExecutionPrompt()
 
 void UMoodHUDWidget::RequestHurtAnimation(int Amount, int NewHealth)
 {
-	if (MoodMeterValue < 666.f)
+	if (MoodMeterValue < GameMode->GetMoodTierTable()->GetTopThreshold())
 	MoodMeterWidget->Face->PlayHurtAnimation();
 	if (!GlitchHurtPlaying)
 	{
@@ -234,12 +218,12 @@ void UMoodHUDWidget::RequestStageAdvanceAnimation(EMoodState IncomingState)
 	}
 }
 
-void UMoodHUDWidget::RequestHitmarkerAnimation()
+void UMoodHUDWidget::RequestHitmarkerAnimation(int32 HitCount)
 {
 	HitmarkerWidget->PlayHitmarkerAnimation();
 }
 
-void UMoodHUDWidget::RequestMoodMeterValueAnimation()
+void UMoodHUDWidget::RequestMoodMeterValueAnimation(int32 HitCount)
 {
 	MoodMeterWidget->PlayMoodMeterNumbersAnimation();
 }
@@ -259,7 +243,7 @@ void UMoodHUDWidget::DisplayWinScreen()
 
 	WinScreen->SetVisibility(ESlateVisibility::HitTestInvisible);
 	WinScreen->PlayFadeAnimation();
-	UGameplayStatics::SetGlobalTimeDilation(GetWorld(), 0.f);
+	GetWorld()->GetSubsystem<UMoodTimeDilationSubsystem>()->PushRequest(WinScreen, 0.f, Etd_Menu);
 }
 
 void UMoodHUDWidget::HideLostScreen()
@@ -268,7 +252,7 @@ void UMoodHUDWidget::HideLostScreen()
 	APlayerController* PlayerController = UGameplayStatics::GetPlayerController(GetWorld(), 0);
 	PlayerController->SetInputMode(FInputModeGameOnly());
 	PlayerController->SetShowMouseCursor(false);
-	UGameplayStatics::SetGlobalTimeDilation(GetWorld(), 1.f);
+	GetWorld()->GetSubsystem<UMoodTimeDilationSubsystem>()->PopRequest(LostScreen);
 	UGameplayStatics::SetGamePaused(GetWorld(),false);
 }
 
@@ -284,7 +268,7 @@ void UMoodHUDWidget::DisplayPauseMenu()
 		APlayerController* PlayerController = UGameplayStatics::GetPlayerController(GetWorld(), 0);
 		PlayerController->SetInputMode(FInputModeUIOnly());
 		PlayerController->SetShowMouseCursor(true);
-		UGameplayStatics::SetGlobalTimeDilation(GetWorld(), 0.f);
+		GetWorld()->GetSubsystem<UMoodTimeDilationSubsystem>()->PushRequest(PauseMenu, 0.f, Etd_Menu);
 		UGameplayStatics::SetGamePaused(GetWorld(), true);
 	}
 }
@@ -300,8 +284,32 @@ void UMoodHUDWidget::NativeConstruct()
 		GetWeaponSlotComponent(Player);
 	}
 	
-	HealthComponent->OnDeath.AddUniqueDynamic(this, &UMoodHUDWidget::DisplayLostScreen);
+	HealthComponent->OnDeathNative.AddUObject(this, &UMoodHUDWidget::DisplayLostScreen);
 	GameMode = Cast<AMoodGameMode>(UGameplayStatics::GetGameMode(GetWorld()));
+	if (auto* LegacyTiers = GameMode->GetLegacyMoodTierTable())
+	{
+		// The 444 tier has always kept the 222 face
+		LegacyTiers->EditTiers(Ems_NoMood, [this](FMoodTier& Tier)
+		{
+			Tier.Tint = TintColorStage0_DEPRECATED;
+			Tier.FaceTint = TintColorStage0_DEPRECATED;
+		});
+		LegacyTiers->EditTiers(Ems_Mood222, [this](FMoodTier& Tier)
+		{
+			Tier.Tint = TintColorStage1_DEPRECATED;
+			Tier.FaceTint = TintColorStage1_DEPRECATED;
+		});
+		LegacyTiers->EditTiers(Ems_Mood444, [this](FMoodTier& Tier)
+		{
+			Tier.Tint = TintColorStage2_DEPRECATED;
+			Tier.FaceTint = TintColorStage1_DEPRECATED;
+		});
+		LegacyTiers->EditTiers(Ems_Mood666, [this](FMoodTier& Tier)
+		{
+			Tier.Tint = TintColorStage3_DEPRECATED;
+			Tier.FaceTint = TintColorStage3_DEPRECATED;
+		});
+	}
 	GameMode->GameFinishedSig.AddUniqueDynamic(this, &UMoodHUDWidget::DisplayWinScreen);
 	GameMode->PlayerRespawn.AddUniqueDynamic(this, &UMoodHUDWidget::HideLostScreen);
 	LostScreen->SetVisibility(ESlateVisibility::Hidden);
@@ -311,12 +319,28 @@ void UMoodHUDWidget::NativeConstruct()
 	MoodMeterWidget->MoodMeterInnerCircle->SetValue(0);
 	MoodMeterWidget->MoodMeterMiddleCircle->SetValue(0);
 	MoodMeterWidget->MoodMeterOuterCircle->SetValue(0);
-	GameMode->OnEnemyHit.AddUniqueDynamic(this, &UMoodHUDWidget::RequestHitmarkerAnimation);
-	GameMode->OnEnemyHit.AddUniqueDynamic(this, &UMoodHUDWidget::RequestMoodMeterValueAnimation);
+	GameMode->OnEnemyHitNative.AddUObject(this, &UMoodHUDWidget::RequestHitmarkerAnimation);
+	GameMode->OnEnemyHitNative.AddUObject(this, &UMoodHUDWidget::RequestMoodMeterValueAnimation);
 	Player->OnPaused.AddUniqueDynamic(this, &UMoodHUDWidget::DisplayPauseMenu);
-	HealthComponent->OnHurt.AddUniqueDynamic(this, &UMoodHUDWidget::RequestHurtAnimation);
+	HealthComponent->OnHurtNative.AddUObject(this, &UMoodHUDWidget::RequestHurtAnimation);
 	GameMode->OnSlowMotionTriggered.AddUniqueDynamic(this, &UMoodHUDWidget::RequestStageAdvanceAnimation);
 	WeaponSlotWidget->GetWeaponSlotComponent(WeaponSlotComponent);
 	ExecutionPrompt->SetVisibility(ESlateVisibility::Hidden);
 }
 
+void UMoodHUDWidget::NativeDestruct()
+{
+	// AddUObject doesn't check for duplicates, unbind so constructing again doesn't bind twice
+	if (HealthComponent != nullptr)
+	{
+		HealthComponent->OnDeathNative.RemoveAll(this);
+		HealthComponent->OnHurtNative.RemoveAll(this);
+	}
+	if (GameMode != nullptr)
+	{
+		GameMode->OnEnemyHitNative.RemoveAll(this);
+	}
+
+	Super::NativeDestruct();
+}
+
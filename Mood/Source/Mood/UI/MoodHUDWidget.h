@@ -111,14 +111,15 @@ public:
 	UPROPERTY()
 	AMoodGameMode* GameMode;
 
-	UPROPERTY(EditDefaultsOnly)
-	FLinearColor TintColorStage0;
-	UPROPERTY(EditDefaultsOnly)
-	FLinearColor TintColorStage1;
-	UPROPERTY(EditDefaultsOnly)
-	FLinearColor TintColorStage2;
-	UPROPERTY(EditDefaultsOnly)
-	FLinearColor TintColorStage3;
+	// Authored before the mood tier table, only used when the game mode has no table asset
+	UPROPERTY()
+	FLinearColor TintColorStage0_DEPRECATED;
+	UPROPERTY()
+	FLinearColor TintColorStage1_DEPRECATED;
+	UPROPERTY()
+	FLinearColor TintColorStage2_DEPRECATED;
+	UPROPERTY()
+	FLinearColor TintColorStage3_DEPRECATED;
 
 
 	UPROPERTY()
@@ -187,15 +188,16 @@ public:
 	void RequestStageAdvanceAnimation(EMoodState IncomingState);
 
 	UFUNCTION()
-	void RequestHitmarkerAnimation();
+	void RequestHitmarkerAnimation(int32 HitCount);
 
 	UFUNCTION()
-	void RequestMoodMeterValueAnimation();
+	void RequestMoodMeterValueAnimation(int32 HitCount);
 
 	UPROPERTY()
 	bool bCanPause;
 
 	virtual void NativeConstruct() override;
+	virtual void NativeDestruct() override;
 
 	
 };
@@ -3,6 +3,7 @@
 #include "MoodGameInstance.h"
 #include "Kismet/GameplayStatics.h"
 #include "Mood/MoodGameMode.h"
+#include "Mood/MoodTimeDilationSubsystem.h"
 #include "MoodCyberButton.h"
 
 void UMoodLostScreen::RestartLevel()
@@ -35,7 +36,7 @@ void UMoodLostScreen::DisplayMenu()
 	APlayerController* PlayerController = UGameplayStatics::GetPlayerController(GetWorld(), 0);
 	PlayerController->SetInputMode(FInputModeUIOnly());
 	PlayerController->SetShowMouseCursor(true);
-	UGameplayStatics::SetGlobalTimeDilation(GetWorld(), 0.f);
+	GetWorld()->GetSubsystem<UMoodTimeDilationSubsystem>()->PushRequest(this, 0.f, Etd_Menu);
 	UGameplayStatics::SetGamePaused(GetWorld(), true);
 }
 
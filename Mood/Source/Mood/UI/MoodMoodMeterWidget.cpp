@@ -2,12 +2,13 @@
 
 #include "Components/RadialSlider.h"
 #include "Components/TextBlock.h"
+#include "Mood/MoodDeterminismSubsystem.h"
 
 void UMoodMoodMeterWidget::PlayMoodMeterNumbersAnimation_Implementation()
 {
 	if (!AnimationPlaying)
 	{
-		AnimationToPlay = FMath::RandRange(0, 2);
+		AnimationToPlay = AnimationStream.RandRange(0, 2);
 		AnimationPlaying = true;
 	}
 }
@@ -15,6 +16,7 @@ void UMoodMoodMeterWidget::PlayMoodMeterNumbersAnimation_Implementation()
 void UMoodMoodMeterWidget::NativeConstruct()
 {
 	Super::NativeConstruct();
+	AnimationStream = UMoodDeterminismSubsystem::MakeStream(this, TEXT("MoodMeterAnimation"));
 	MoodMeterInnerCircle->SetValue(1.0f);
 	MoodMeterInnerCircle->Value = 0.f;
 	MoodMeterMiddleCircle->Value = 0.f;
@@ -46,5 +46,8 @@ public:
 
 protected:
 	virtual void NativeConstruct() override;
+
+private:
+	FRandomStream AnimationStream;
 	
 };
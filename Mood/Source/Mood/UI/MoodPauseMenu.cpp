@@ -3,6 +3,7 @@
 #include "MoodOptionsMenuWidget.h"
 #include "Kismet/GameplayStatics.h"
 #include "../MoodHealthComponent.h"
+#include "../MoodTimeDilationSubsystem.h"
 
 void UMoodPauseMenu::OpenOptionsMenu_Implementation()
 {
@@ -15,7 +16,7 @@ void UMoodPauseMenu::ResumeGame_Implementation()
 	APlayerController* PlayerController = UGameplayStatics::GetPlayerController(GetWorld(), 0);
 	PlayerController->SetInputMode(FInputModeGameOnly());
 	PlayerController->SetShowMouseCursor(false);
-	UGameplayStatics::SetGlobalTimeDilation(GetWorld(), 1.f);
+	GetWorld()->GetSubsystem<UMoodTimeDilationSubsystem>()->PopRequest(this);
 	UGameplayStatics::SetGamePaused(GetWorld(), false);
 }
 
@@ -25,7 +26,7 @@ void UMoodPauseMenu::RestartLevel()
 	APlayerController* PlayerController = UGameplayStatics::GetPlayerController(GetWorld(), 0);
 	PlayerController->SetInputMode(FInputModeGameOnly());
 	PlayerController->SetShowMouseCursor(false);
-	UGameplayStatics::SetGlobalTimeDilation(GetWorld(), 1.f);
+	GetWorld()->GetSubsystem<UMoodTimeDilationSubsystem>()->PopRequest(this);
 	UGameplayStatics::SetGamePaused(GetWorld(), false);
 	Super::RestartLevel();
 }
@@ -47,7 +48,7 @@ void UMoodPauseMenu::KillPlayerInPause()
 	APlayerController* PlayerController = UGameplayStatics::GetPlayerController(GetWorld(), 0);
 	PlayerController->SetInputMode(FInputModeGameOnly());
 	PlayerController->SetShowMouseCursor(false);
-	UGameplayStatics::SetGlobalTimeDilation(GetWorld(), 1.f);
+	GetWorld()->GetSubsystem<UMoodTimeDilationSubsystem>()->PopRequest(this);
 	UGameplayStatics::SetGamePaused(GetWorld(), false);
 	PlayerHealth->Hurt(10000000);
 }
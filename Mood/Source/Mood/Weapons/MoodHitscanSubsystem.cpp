@@ -0,0 +1,81 @@
+#include "MoodHitscanSubsystem.h"
+
+#include "MoodWeaponComponent.h"
+#include "Async/ParallelFor.h"
+#include "Engine/World.h"
+#include "Mood/MoodHitboxComponent.h"
+
+void UMoodHitscanSubsystem::RequestShot(UMoodWeaponComponent* Weapon, const FVector& Start, TConstArrayView<FVector> Ends,
+                                        float DamageMultiplier) {
+	FShot Shot;
+	Shot.Weapon = Weapon;
+	Shot.IgnoredActor = Weapon->GetAttachmentRootActor();
+	Shot.Start = Start;
+	Shot.DamageMultiplier = DamageMultiplier;
+	Shot.FirstTrace = TraceEnds.Num();
+	Shot.NumTraces = Ends.Num();
+
+	const auto ShotIndex = Shots.Add(Shot);
+	TraceEnds.Append(Ends.GetData(), Ends.Num());
+	for (auto i = 0; i < Ends.Num(); i++) {
+		TraceShots.Add(ShotIndex);
+	}
+}
+
+void UMoodHitscanSubsystem::Tick(float DeltaTime) {
+	Super::Tick(DeltaTime);
+
+	RunTraces();
+	ResolveTraces();
+}
+
+TStatId UMoodHitscanSubsystem::GetStatId() const {
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UMoodHitscanSubsystem, STATGROUP_Tickables);
+}
+
+void UMoodHitscanSubsystem::RunTraces() {
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_MoodHitscan_RunTraces);
+
+	const auto* World = GetWorld();
+	Hits.Reset();
+	Hits.SetNum(TraceEnds.Num());
+
+	// Nothing moves while the batch runs, so the queries only need the scene's read lock
+	const auto Flags = TraceEnds.Num() < MinParallelTraces ? EParallelForFlags::ForceSingleThread : EParallelForFlags::None;
+	ParallelFor(TraceEnds.Num(), [this, World](int32 Index) {
+		const auto& Shot = Shots[TraceShots[Index]];
+		FCollisionQueryParams CollisionQueryParams(SCENE_QUERY_STAT(MoodHitscan));
+		CollisionQueryParams.AddIgnoredActor(Shot.IgnoredActor);
+		World->LineTraceSingleByChannel(Hits[Index], Shot.Start, TraceEnds[Index], ECC_Hitscan, CollisionQueryParams);
+	}, Flags);
+}
+
+void UMoodHitscanSubsystem::ResolveTraces() {
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_MoodHitscan_ResolveTraces);
+
+	// Swapped out first, resolving can make weapons fire and request more shots for the next batch
+	auto BatchShots = MoveTemp(Shots);
+	auto BatchEnds = MoveTemp(TraceEnds);
+	auto BatchHits = MoveTemp(Hits);
+	TraceShots.Reset();
+
+	for (const auto& Shot : BatchShots) {
+		if (auto* Weapon = Shot.Weapon.Get()) {
+			const auto Ends = TConstArrayView<FVector>(BatchEnds).Slice(Shot.FirstTrace, Shot.NumTraces);
+			const auto ShotHits = TConstArrayView<FHitResult>(BatchHits).Slice(Shot.FirstTrace, Shot.NumTraces);
+			Weapon->ResolveShot(Shot.Start, Ends, ShotHits, Shot.DamageMultiplier);
+		}
+	}
+
+	// Keep the allocations around for the next frame
+	BatchShots.Reset();
+	BatchEnds.Reset();
+	BatchHits.Reset();
+	if (Shots.Num() == 0) {
+		Shots = MoveTemp(BatchShots);
+		TraceEnds = MoveTemp(BatchEnds);
+	}
+	if (Hits.Num() == 0) {
+		Hits = MoveTemp(BatchHits);
+	}
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "MoodHitscanSubsystem.generated.h"
+
+class UMoodWeaponComponent;
+
+/**
+ * Collects every hitscan shot weapons fire during a frame and runs all their traces as one batch
+ * after the actors have ticked. The traces are spread over the worker threads, then each weapon gets
+ * the results of a whole shot back on the game thread, in the order the shots were requested.
+ */
+UCLASS()
+class UMoodHitscanSubsystem : public UTickableWorldSubsystem {
+	GENERATED_BODY()
+
+public:
+	// One trace from Start to each of the ends, resolved together as one shot
+	void RequestShot(UMoodWeaponComponent* Weapon, const FVector& Start, TConstArrayView<FVector> Ends,
+	                 float DamageMultiplier);
+
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override { return Shots.Num() > 0; }
+	virtual TStatId GetStatId() const override;
+
+private:
+	// Below this many traces the batch stays on the game thread, waking workers would cost more
+	static constexpr int32 MinParallelTraces = 8;
+
+	struct FShot {
+		TWeakObjectPtr<UMoodWeaponComponent> Weapon;
+		const AActor* IgnoredActor = nullptr;
+		FVector Start = FVector::ZeroVector;
+		float DamageMultiplier = 1.f;
+		// Range of this shot's traces in TraceEnds and Hits
+		int32 FirstTrace = 0;
+		int32 NumTraces = 0;
+	};
+	TArray<FShot> Shots;
+	// Shot of every trace, so the workers don't have to search the ranges
+	TArray<int32> TraceShots;
+	TArray<FVector> TraceEnds;
+	TArray<FHitResult> Hits;
+
+	void RunTraces();
+	void ResolveTraces();
+};
@@ -0,0 +1,49 @@
+#include "MoodImpactEffectSubsystem.h"
+
+#include "Camera/PlayerCameraManager.h"
+#include "Engine/World.h"
+#include "Kismet/GameplayStatics.h"
+#include "NiagaraFunctionLibrary.h"
+
+bool UMoodImpactEffectSubsystem::PlayEffect(UNiagaraSystem* System, const FVector& Location, const FRotator& Rotation) {
+	if (System == nullptr) {
+		return false;
+	}
+
+	if (BudgetFrame != GFrameCounter) {
+		BudgetFrame = GFrameCounter;
+		EffectsThisFrame = 0;
+	}
+	if (EffectsThisFrame >= MaxEffectsPerFrame || !IsSignificant(Location)) {
+		return false;
+	}
+	EffectsThisFrame++;
+
+	// The component goes back to the pool by itself once the system completes
+	UNiagaraFunctionLibrary::SpawnSystemAtLocation(
+		GetWorld(), System, Location, Rotation, FVector::OneVector,
+		true, true, ENCPoolMethod::AutoRelease
+	);
+	return true;
+}
+
+bool UMoodImpactEffectSubsystem::IsSignificant(const FVector& Location) const {
+	const auto* Camera = UGameplayStatics::GetPlayerCameraManager(GetWorld(), 0);
+	if (Camera == nullptr) {
+		return true;
+	}
+
+	const auto ToEffect = Location - Camera->GetCameraLocation();
+	const auto Distance = ToEffect.Size();
+	if (Distance > MaxEffectDistance) {
+		return false;
+	}
+
+	// Right at the camera the direction means nothing, and it's too close to miss anyway
+	if (Distance < UE_KINDA_SMALL_NUMBER) {
+		return true;
+	}
+	const auto MaxAngle = FMath::DegreesToRadians(FMath::Min(Camera->GetFOVAngle() * 0.5f + ViewAngleMargin, 180.f));
+	const auto CosAngle = FVector::DotProduct(ToEffect / Distance, Camera->GetCameraRotation().Vector());
+	return CosAngle >= FMath::Cos(MaxAngle);
+}
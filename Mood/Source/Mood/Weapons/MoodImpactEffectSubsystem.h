@@ -0,0 +1,32 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "MoodImpactEffectSubsystem.generated.h"
+
+class UNiagaraSystem;
+
+/**
+ * Plays impact effects from Niagara's component pool, so shooting never creates or destroys components.
+ * How many components a system keeps around is set on the system asset. Impacts far away or out of
+ * view are skipped, as is anything over the per-frame budget.
+ */
+UCLASS()
+class UMoodImpactEffectSubsystem : public UWorldSubsystem {
+	GENERATED_BODY()
+
+public:
+	// False when the effect was culled or over budget
+	bool PlayEffect(UNiagaraSystem* System, const FVector& Location, const FRotator& Rotation);
+
+private:
+	static constexpr int32 MaxEffectsPerFrame = 12;
+	static constexpr double MaxEffectDistance = 6000.0;
+	// Added to half the camera's field of view, so impacts at the edge of the screen aren't cut off
+	static constexpr float ViewAngleMargin = 10.f;
+
+	uint64 BudgetFrame = 0;
+	int32 EffectsThisFrame = 0;
+
+	bool IsSignificant(const FVector& Location) const;
+};
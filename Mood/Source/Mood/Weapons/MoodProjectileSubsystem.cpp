@@ -0,0 +1,191 @@
+#include "MoodProjectileSubsystem.h"
+
+#include "MoodImpactEffectSubsystem.h"
+#include "MoodWeaponDefinition.h"
+#include "Async/ParallelFor.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Engine/World.h"
+#include "Mood/MoodHealthComponent.h"
+#include "Mood/MoodHitboxComponent.h"
+#include "NiagaraSystem.h"
+
+void UMoodProjectileSubsystem::Launch(const UMoodWeaponDefinition* Definition, const FVector& Origin,
+                                      const FVector& Direction, int32 Damage, AActor* Instigator) {
+	if (Definition == nullptr) {
+		return;
+	}
+
+	Positions.Add(Origin);
+	Velocities.Add(Direction.GetSafeNormal() * Definition->ProjectileSpeed);
+	Bounces.Add(0);
+	TypeIndices.Add(GetTypeIndex(Definition));
+	ExpireTimes.Add(GetWorld()->GetTimeSeconds() + Types[TypeIndices.Last()].Lifetime);
+	Damages.Add(Damage);
+	Instigators.Add(Instigator);
+}
+
+void UMoodProjectileSubsystem::Tick(float DeltaTime) {
+	Super::Tick(DeltaTime);
+
+	// Expired first, there's no point moving them
+	const auto Now = GetWorld()->GetTimeSeconds();
+	for (auto i = Positions.Num() - 1; i >= 0; i--) {
+		if (ExpireTimes[i] <= Now) {
+			RemoveProjectile(i);
+		}
+	}
+
+	Sweep(DeltaTime);
+	ResolveHits();
+	UpdateInstances();
+}
+
+TStatId UMoodProjectileSubsystem::GetStatId() const {
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UMoodProjectileSubsystem, STATGROUP_Tickables);
+}
+
+int32 UMoodProjectileSubsystem::GetTypeIndex(const UMoodWeaponDefinition* Definition) {
+	// Only a handful of weapon definitions fire projectiles, a search is cheaper than a map
+	const auto Existing = Types.IndexOfByPredicate([Definition](const FMoodProjectileType& Type) {
+		return Type.Definition == Definition;
+	});
+	if (Existing != INDEX_NONE) {
+		return Existing;
+	}
+
+	auto* World = GetWorld();
+	if (InstanceHost == nullptr) {
+		FActorSpawnParameters SpawnParameters;
+		SpawnParameters.Name = TEXT("MoodProjectiles");
+		SpawnParameters.NameMode = FActorSpawnParameters::ESpawnActorNameMode::Requested;
+		InstanceHost = World->SpawnActor<AActor>(SpawnParameters);
+	}
+
+	FMoodProjectileType Type;
+	Type.Definition = Definition;
+	Type.Radius = Definition->ProjectileRadius;
+	Type.GravityZ = World->GetGravityZ() * Definition->ProjectileGravityScale;
+	Type.Bounciness = Definition->ProjectileBounciness;
+	Type.MaxBounces = Definition->ProjectileMaxBounces;
+	Type.Lifetime = Definition->ProjectileLifetime;
+
+	Type.Instances = NewObject<UInstancedStaticMeshComponent>(InstanceHost);
+	Type.Instances->SetMobility(EComponentMobility::Movable);
+	Type.Instances->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	Type.Instances->SetCastShadow(false);
+	Type.Instances->RegisterComponent();
+
+	return Types.Add(MoveTemp(Type));
+}
+
+void UMoodProjectileSubsystem::Sweep(float DeltaTime) {
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_MoodProjectile_Sweep);
+
+	const auto* World = GetWorld();
+	const auto Num = Positions.Num();
+	Hits.Reset();
+	Hits.SetNum(Num);
+	IgnoredActors.Reset();
+	for (const auto& Instigator : Instigators) {
+		IgnoredActors.Add(Instigator.Get());
+	}
+
+	// Every projectile only reads and writes its own row, and nothing moves while the sweeps run
+	const auto Flags = Num < MinParallelProjectiles ? EParallelForFlags::ForceSingleThread : EParallelForFlags::None;
+	ParallelFor(Num, [this, World, DeltaTime](int32 Index) {
+		const auto& Type = Types[TypeIndices[Index]];
+		Velocities[Index].Z += Type.GravityZ * DeltaTime;
+		const auto End = Positions[Index] + Velocities[Index] * DeltaTime;
+
+		FCollisionQueryParams CollisionQueryParams(SCENE_QUERY_STAT(MoodProjectile));
+		CollisionQueryParams.AddIgnoredActor(IgnoredActors[Index]);
+		World->SweepSingleByChannel(Hits[Index], Positions[Index], End, FQuat::Identity, ECC_Hitscan,
+		                            FCollisionShape::MakeSphere(Type.Radius), CollisionQueryParams);
+		Positions[Index] = Hits[Index].bBlockingHit ? Hits[Index].Location : End;
+	}, Flags);
+}
+
+void UMoodProjectileSubsystem::ResolveHits() {
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_MoodProjectile_ResolveHits);
+
+	auto* ImpactEffects = GetWorld()->GetSubsystem<UMoodImpactEffectSubsystem>();
+
+	// Backwards, so removing a projectile only moves one that has already been looked at
+	for (auto i = Positions.Num() - 1; i >= 0; i--) {
+		const auto& Hit = Hits[i];
+		if (!Hit.bBlockingHit) {
+			continue;
+		}
+
+		const auto& Type = Types[TypeIndices[i]];
+		auto* Health = UMoodHealthComponent::Get(Hit.GetActor());
+		if (Health == nullptr && Bounces[i] < Type.MaxBounces) {
+			Velocities[i] = FMath::GetReflectionVector(Velocities[i], Hit.ImpactNormal) * Type.Bounciness;
+			Positions[i] += Hit.ImpactNormal * BounceOffset;
+			Bounces[i]++;
+			continue;
+		}
+
+		if (Health != nullptr) {
+			const auto* Hitboxes = UMoodHitboxComponent::Get(Hit.GetActor());
+			const auto Locational = Hitboxes ? Hitboxes->GetDamageMultiplier(Hit.GetComponent()) : 1.f;
+			Health->Hurt(MoodRules::ComputePelletDamage(Damages[i], Locational), Instigators[i].Get());
+		}
+		// Physics objects get pushed the way the projectile actors used to push them
+		else if (auto* Component = Hit.GetComponent(); Component && Component->IsSimulatingPhysics()) {
+			Component->AddImpulseAtLocation(Velocities[i] * 100.0f, Hit.ImpactPoint);
+		}
+
+		auto* HitEffect = Type.Definition->HitEffect.Get();
+		if (ImpactEffects && HitEffect) {
+			ImpactEffects->PlayEffect(HitEffect, Hit.ImpactPoint, FRotator::ZeroRotator);
+		}
+		RemoveProjectile(i);
+	}
+}
+
+void UMoodProjectileSubsystem::RemoveProjectile(int32 Index) {
+	Positions.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	Velocities.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	Bounces.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	ExpireTimes.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	TypeIndices.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	Damages.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	Instigators.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	if (Hits.IsValidIndex(Index)) {
+		Hits.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	}
+}
+
+void UMoodProjectileSubsystem::UpdateInstances() {
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_MoodProjectile_UpdateInstances);
+
+	for (auto& Type : Types) {
+		Type.Transforms.Reset();
+	}
+	for (auto i = 0; i < Positions.Num(); i++) {
+		const auto Rotation = Velocities[i].ToOrientationQuat();
+		Types[TypeIndices[i]].Transforms.Emplace(Rotation, Positions[i]);
+	}
+
+	bHasInstances = false;
+	for (auto& Type : Types) {
+		auto* Instances = Type.Instances.Get();
+		// The mesh comes with the weapon's effects bundle, until then the projectiles fly unseen
+		if (Instances->GetStaticMesh() == nullptr) {
+			Instances->SetStaticMesh(Type.Definition->ProjectileMesh.Get());
+		}
+
+		// Same count means the instances can be moved in place, otherwise they're rebuilt in one go
+		if (Instances->GetInstanceCount() == Type.Transforms.Num()) {
+			if (Type.Transforms.Num() > 0) {
+				Instances->BatchUpdateInstancesTransforms(0, Type.Transforms, true, true, true);
+			}
+		}
+		else {
+			Instances->ClearInstances();
+			Instances->AddInstances(Type.Transforms, false, true);
+		}
+		bHasInstances |= Type.Transforms.Num() > 0;
+	}
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "MoodProjectileSubsystem.generated.h"
+
+class UInstancedStaticMeshComponent;
+class UMoodWeaponDefinition;
+
+// Everything projectiles of one weapon definition share, copied out so the workers never touch the asset
+USTRUCT()
+struct FMoodProjectileType {
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TObjectPtr<const UMoodWeaponDefinition> Definition = nullptr;
+	UPROPERTY()
+	TObjectPtr<UInstancedStaticMeshComponent> Instances = nullptr;
+	// Instance transforms of this frame, gathered before they're handed to the component
+	TArray<FTransform> Transforms;
+
+	float Radius = 5.f;
+	float GravityZ = 0.f;
+	float Bounciness = 0.6f;
+	int32 MaxBounces = 0;
+	float Lifetime = 3.f;
+};
+
+/**
+ * Simulates every projectile in flight as rows of plain arrays, instead of an actor with its own collision and
+ * movement component for each one. The projectiles move and sweep against the world in parallel once the actors
+ * have ticked, the hits are resolved on the game thread, and each weapon definition draws all of its
+ * projectiles through one instanced static mesh.
+ */
+UCLASS()
+class UMoodProjectileSubsystem : public UTickableWorldSubsystem {
+	GENERATED_BODY()
+
+public:
+	void Launch(const UMoodWeaponDefinition* Definition, const FVector& Origin, const FVector& Direction, int32 Damage,
+	            AActor* Instigator);
+	int32 GetNumProjectiles() const { return Positions.Num(); }
+
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override { return Positions.Num() > 0 || bHasInstances; }
+	virtual TStatId GetStatId() const override;
+
+private:
+	// Below this many projectiles the sweeps stay on the game thread, waking workers would cost more
+	static constexpr int32 MinParallelProjectiles = 8;
+	// Pushed off the surface after a bounce, so the next sweep doesn't start inside it
+	static constexpr float BounceOffset = 0.1f;
+
+	UPROPERTY()
+	TArray<FMoodProjectileType> Types;
+	// Owns the instanced mesh components, the only actor the projectiles need
+	UPROPERTY()
+	TObjectPtr<AActor> InstanceHost = nullptr;
+	bool bHasInstances = false;
+
+	// One row per projectile in flight, removed by swapping with the last one
+	TArray<FVector> Positions;
+	TArray<FVector> Velocities;
+	TArray<int32> Bounces;
+	TArray<double> ExpireTimes;
+	TArray<int32> TypeIndices;
+	TArray<int32> Damages;
+	TArray<TWeakObjectPtr<AActor>> Instigators;
+
+	// Filled on the game thread for the sweeps, a destroyed instigator is only ever seen as null
+	TArray<const AActor*> IgnoredActors;
+	TArray<FHitResult> Hits;
+
+	int32 GetTypeIndex(const UMoodWeaponDefinition* Definition);
+	void Sweep(float DeltaTime);
+	void ResolveHits();
+	void RemoveProjectile(int32 Index);
+	void UpdateInstances();
+};
@@ -0,0 +1,83 @@
+#include "MoodTracerSubsystem.h"
+
+#include "Engine/World.h"
+#include "NiagaraComponent.h"
+#include "NiagaraDataInterfaceArrayFunctionLibrary.h"
+#include "NiagaraFunctionLibrary.h"
+
+const FName UMoodTracerSubsystem::StartsParameter = TEXT("TracerStarts");
+const FName UMoodTracerSubsystem::EndsParameter = TEXT("TracerEnds");
+const FName UMoodTracerSubsystem::CountParameter = TEXT("TracerCount");
+
+void UMoodTracerSubsystem::Initialize(FSubsystemCollectionBase& Collection) {
+	Super::Initialize(Collection);
+
+	// The hitscan batch resolves during the tickables, so every tracer of the frame is in by then
+	PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &UMoodTracerSubsystem::OnWorldPostActorTick);
+}
+
+void UMoodTracerSubsystem::Deinitialize() {
+	FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickHandle);
+
+	Super::Deinitialize();
+}
+
+void UMoodTracerSubsystem::AddTracer(UNiagaraSystem* System, const FVector& Start, const FVector& End) {
+	if (System == nullptr) {
+		return;
+	}
+
+	auto& Batch = GetBatch(System);
+	Batch.Starts.Add(Start);
+	Batch.Ends.Add(End);
+}
+
+FMoodTracerBatch& UMoodTracerSubsystem::GetBatch(UNiagaraSystem* System) {
+	// Only a handful of weapon families, a search is cheaper than a map
+	if (auto* Batch = Batches.FindByPredicate([System](const FMoodTracerBatch& Other) { return Other.System == System; })) {
+		return *Batch;
+	}
+
+	auto& Batch = Batches.AddDefaulted_GetRef();
+	Batch.System = System;
+	return Batch;
+}
+
+void UMoodTracerSubsystem::OnWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds) {
+	if (World != GetWorld())
+		return;
+
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_MoodTracer_Upload);
+
+	for (auto& Batch : Batches) {
+		const auto Count = Batch.Starts.Num();
+		// Nothing to add, and the system already knows there is nothing to spawn
+		if (Count == 0 && Batch.UploadedCount == 0) {
+			continue;
+		}
+
+		if (Batch.Component == nullptr) {
+			Batch.Component = UNiagaraFunctionLibrary::SpawnSystemAtLocation(
+				World, Batch.System, FVector::ZeroVector, FRotator::ZeroRotator, FVector::OneVector,
+				false, true, ENCPoolMethod::None, false
+			);
+			if (Batch.Component == nullptr) {
+				UE_LOG(LogTemp, Error, TEXT("Failed to spawn tracer system %s"), *GetNameSafe(Batch.System));
+				Batch.Starts.Reset();
+				Batch.Ends.Reset();
+				continue;
+			}
+		}
+
+		if (Count > 0) {
+			UNiagaraDataInterfaceArrayFunctionLibrary::SetNiagaraArrayVector(Batch.Component, StartsParameter, Batch.Starts);
+			UNiagaraDataInterfaceArrayFunctionLibrary::SetNiagaraArrayVector(Batch.Component, EndsParameter, Batch.Ends);
+		}
+		Batch.Component->SetVariableInt(CountParameter, Count);
+		Batch.UploadedCount = Count;
+
+		// Keeps the allocations for the next frame's segments
+		Batch.Starts.Reset();
+		Batch.Ends.Reset();
+	}
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "MoodTracerSubsystem.generated.h"
+
+class UNiagaraComponent;
+class UNiagaraSystem;
+
+USTRUCT()
+struct FMoodTracerBatch {
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TObjectPtr<UNiagaraSystem> System = nullptr;
+	UPROPERTY()
+	TObjectPtr<UNiagaraComponent> Component = nullptr;
+	// Segments added this frame, uploaded together once the actors have ticked
+	TArray<FVector> Starts;
+	TArray<FVector> Ends;
+	int32 UploadedCount = 0;
+};
+
+/**
+ * Draws the tracers of every weapon with one persistent Niagara component per tracer system, instead of an
+ * effect per pellet. The segments of a frame go to the system in one go through its user parameters:
+ * the vector arrays TracerStarts and TracerEnds, and TracerCount, the number of tracers to spawn this frame.
+ */
+UCLASS()
+class UMoodTracerSubsystem : public UWorldSubsystem {
+	GENERATED_BODY()
+
+public:
+	static const FName StartsParameter;
+	static const FName EndsParameter;
+	static const FName CountParameter;
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	void AddTracer(UNiagaraSystem* System, const FVector& Start, const FVector& End);
+
+private:
+	UPROPERTY()
+	TArray<FMoodTracerBatch> Batches;
+
+	FDelegateHandle PostActorTickHandle;
+
+	void OnWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+	FMoodTracerBatch& GetBatch(UNiagaraSystem* System);
+};
@@ -4,17 +4,131 @@
 #include "Kismet/GameplayStatics.h"
 #include "Engine/World.h"
 #include "Kismet/KismetMathLibrary.h"
+#include "Mood/MoodAttributeComponent.h"
+#include "Mood/MoodDeterminismSubsystem.h"
 #include "Mood/MoodHealthComponent.h"
+#include "Mood/MoodHitboxComponent.h"
+#include "Mood/MoodTimeDilationSubsystem.h"
+#include "Mood/Telemetry/MoodTelemetrySubsystem.h"
+#include "MoodHitscanSubsystem.h"
+#include "MoodImpactEffectSubsystem.h"
+#include "MoodProjectileSubsystem.h"
+#include "MoodTracerSubsystem.h"
+#include "MoodWeaponDefinition.h"
+#include "Engine/AssetManager.h"
+#include "NiagaraSystem.h"
+
+namespace {
+	using FPelletEnds = TArray<FVector, TInlineAllocator<8>>;
+
+	// The spread follows the muzzle, so the pattern keeps its shape wherever the shot is aimed
+	void GetPelletEnds(const UMoodWeaponDefinition& Weapon, FRandomStream& SpreadStream, const FVector& Origin,
+	                   const FQuat& Rotation, FPelletEnds& OutEnds) {
+		const auto& SpreadTable = Weapon.GetSpreadTable();
+		OutEnds.SetNumUninitialized(SpreadTable.PelletsPerShot);
+		const auto Pattern = MoodRules::PickSpreadPattern(SpreadTable, SpreadStream);
+		MoodRules::TransformSpread(SpreadTable, Pattern, Origin, Rotation, Weapon.Range, OutEnds);
+	}
+
+	struct FHitscanFirePolicy {
+		static int32 GetNumTraces(const UMoodWeaponDefinition& Weapon) { return Weapon.PelletsPerShot; }
+
+		static void Fire(UMoodWeaponComponent& Component, const UMoodWeaponDefinition& Weapon, FRandomStream& SpreadStream,
+		                 const FVector& Origin, const FQuat& Rotation, float DamageMultiplier) {
+			auto* Hitscan = Component.GetWorld()->GetSubsystem<UMoodHitscanSubsystem>();
+			if (Hitscan == nullptr) {
+				return;
+			}
+
+			FPelletEnds PelletEnds;
+			GetPelletEnds(Weapon, SpreadStream, Origin, Rotation, PelletEnds);
+			// Traced together with every other shot of the frame, the results come back in ResolveShot
+			Hitscan->RequestShot(&Component, Origin, PelletEnds, DamageMultiplier);
+		}
+	};
+
+	struct FProjectileFirePolicy {
+		static int32 GetNumTraces(const UMoodWeaponDefinition& Weapon) { return Weapon.PelletsPerShot; }
+
+		static void Fire(UMoodWeaponComponent& Component, const UMoodWeaponDefinition& Weapon, FRandomStream& SpreadStream,
+		                 const FVector& Origin, const FQuat& Rotation, float DamageMultiplier) {
+			auto* Projectiles = Component.GetWorld()->GetSubsystem<UMoodProjectileSubsystem>();
+			if (Projectiles == nullptr) {
+				return;
+			}
+
+			FPelletEnds PelletEnds;
+			GetPelletEnds(Weapon, SpreadStream, Origin, Rotation, PelletEnds);
+			const auto PelletDamage = MoodRules::ComputePelletDamage(Weapon.DamagePerPellet, DamageMultiplier);
+			auto* Instigator = Component.GetAttachmentRootActor();
+			for (const auto& End : PelletEnds) {
+				Projectiles->Launch(&Weapon, Origin, End - Origin, PelletDamage, Instigator);
+			}
+		}
+	};
+
+	struct FMeleeFirePolicy {
+		static int32 GetNumTraces(const UMoodWeaponDefinition& Weapon) { return 1; }
+
+		static void Fire(UMoodWeaponComponent& Component, const UMoodWeaponDefinition& Weapon, FRandomStream& SpreadStream,
+		                 const FVector& Origin, const FQuat& Rotation, float DamageMultiplier) {
+			const auto End = Origin + Rotation.GetForwardVector() * Weapon.Range;
+			FCollisionQueryParams CollisionQueryParams(SCENE_QUERY_STAT(MoodMelee));
+			CollisionQueryParams.AddIgnoredActor(Component.GetAttachmentRootActor());
+
+			// A single short sweep isn't worth waiting for the batch, the swing lands right away
+			FHitResult Hit;
+			Component.GetWorld()->SweepSingleByChannel(Hit, Origin, End, FQuat::Identity, ECC_Hitscan,
+			                                           FCollisionShape::MakeSphere(Weapon.MeleeRadius), CollisionQueryParams);
+			// A target already inside the sphere where the swing starts is the usual point blank hit, not a miss
+			if (Hit.bBlockingHit && Hit.bStartPenetrating) {
+				Hit.bStartPenetrating = false;
+				Hit.Location = Hit.ImpactPoint;
+			}
+			// Worth every pellet, as much as the old point blank shotgun melee weapons
+			Component.ResolveShot(Origin, MakeArrayView(&End, 1), MakeArrayView(&Hit, 1),
+			                      DamageMultiplier * Weapon.PelletsPerShot);
+		}
+	};
+}
 
 // Sets default values for this component's properties
 /**
  * 
  */
 UMoodWeaponComponent::UMoodWeaponComponent(): USkeletalMeshComponent() {
-	PrimaryComponentTick.bCanEverTick = true;
+}
+
+UMoodWeaponComponent* UMoodWeaponComponent::Create(AActor* Owner, const UMoodWeaponDefinition* InDefinition) {
+	if (!Owner || !InDefinition) {
+		return nullptr;
+	}
+
+	const auto Name = MakeUniqueObjectName(Owner, StaticClass(), InDefinition->GetFName());
+	auto* Weapon = NewObject<UMoodWeaponComponent>(Owner, Name);
+	Weapon->Definition = InDefinition;
+	Weapon->SetSkeletalMeshAsset(InDefinition->Mesh);
+	Weapon->SetAnimInstanceClass(InDefinition->AnimClass);
+	// Registered after the setup, so BeginPlay already sees the definition and the anim instance
+	Weapon->RegisterComponent();
+	return Weapon;
+}
+
+UMoodWeaponComponent* UMoodWeaponComponent::CreateFromTemplate(AActor* Owner, UMoodWeaponComponent* Template) {
+	if (!Owner || !Template) {
+		return nullptr;
+	}
+
+	const auto Name = MakeUniqueObjectName(Owner, Template->GetClass(), Template->GetFName());
+	auto* Weapon = NewObject<UMoodWeaponComponent>(Owner, Template->GetClass(), Name, RF_NoFlags, Template);
+	// The template is attached inside its pickup, the slot attaches the copy to its owner
+	Weapon->SetupAttachment(nullptr);
+	Weapon->RegisterComponent();
+	return Weapon;
 }
 
 bool UMoodWeaponComponent::TryAddAmmo(int Amount) {
+	const auto MaxAmmo = GetDefinition()->MaxAmmo;
 	if (CurrentAmmo == MaxAmmo) { return false; }
 	
 	Amount = abs(Amount);
@@ -26,89 +140,254 @@ bool UMoodWeaponComponent::TryAddAmmo(int Amount) {
 	return true;
 }
 
-void UMoodWeaponComponent::TraceHit(UWorld* World, FVector MuzzleOrigin, FVector MuzzleDirection, float DamageMultiplier) {
-	auto LineTraceEnd = MuzzleOrigin + MuzzleDirection * Range;
-	FHitResult Hit {};
-	FCollisionQueryParams CollisionQueryParams{};
-	CollisionQueryParams.AddIgnoredActor(GetAttachmentRootActor());
-	World->LineTraceSingleByChannel(Hit, MuzzleOrigin, LineTraceEnd, ECC_Visibility, CollisionQueryParams);
-
-	if (DebugBullet) {
-		DrawDebugLine(
-			World, MuzzleOrigin, LineTraceEnd, FColor::Green,
-			false, 0.25f, 0, 0.25f
-		);
-	}
-
-	auto ValidHit = Hit.IsValidBlockingHit();
-	if (ValidHit) {
-		auto HitActor = Hit.GetActor();
-		if (HitActor) {
-			auto Health = HitActor->GetComponentByClass<UMoodHealthComponent>();
-			if (Health) {
-				auto ActualDamage = FMath::FloorToInt32(DamagePerPellet * DamageMultiplier);
-				Health->Hurt(ActualDamage);
-				if (DebugBullet) {
-					UE_LOG(LogTemp, Log, TEXT("Shot %ls"), *Hit.GetActor()->GetActorNameOrLabel());
+void UMoodWeaponComponent::ResolveShot(const FVector& TraceStart, TConstArrayView<FVector> TraceEnds,
+                                       TConstArrayView<FHitResult> Hits, float DamageMultiplier) {
+	// Pellets hitting the same actor are summed up, so it's only hurt, and reacts to it, once per shot
+	TArray<FMoodShotHit, TInlineAllocator<8>> ShotHits;
+	const auto DamagePerPellet = GetDefinition()->DamagePerPellet;
+	// Not loaded yet means no impact effect, rather than a hitch loading it in the middle of a fight
+	auto* HitEffect = GetDefinition()->HitEffect.Get();
+	auto* ImpactEffects = HitEffect ? GetWorld()->GetSubsystem<UMoodImpactEffectSubsystem>() : nullptr;
+	const auto LegacyHitEffect = Definition == nullptr ? HitEffect_DEPRECATED : nullptr;
+	auto* TracerSystem = GetDefinition()->TracerSystem.Get();
+	auto* Tracers = TracerSystem ? GetWorld()->GetSubsystem<UMoodTracerSubsystem>() : nullptr;
+
+	for (auto i = 0; i < Hits.Num(); i++) {
+		const auto& Hit = Hits[i];
+		if (DebugBullet) {
+			DrawDebugLine(
+				GetWorld(), TraceStart, TraceEnds[i], FColor::Green,
+				false, 0.25f, 0, 0.25f
+			);
+		}
+
+		if (Hit.IsValidBlockingHit()) {
+			auto HitActor = Hit.GetActor();
+			if (HitActor) {
+				auto* ShotHit = ShotHits.FindByPredicate([HitActor](const FMoodShotHit& Other) {
+					return Other.Victim == HitActor;
+				});
+				if (ShotHit == nullptr) {
+					ShotHit = &ShotHits.AddDefaulted_GetRef();
+					ShotHit->Victim = HitActor;
+					ShotHit->Health = UMoodHealthComponent::Get(HitActor);
+					ShotHit->Hitboxes = ShotHit->Health ? UMoodHitboxComponent::Get(HitActor) : nullptr;
+				}
+				if (ShotHit->Health) {
+					// Each pellet is scaled by the body part it hit
+					const auto Locational = ShotHit->Hitboxes ? ShotHit->Hitboxes->GetDamageMultiplier(Hit.GetComponent()) : 1.f;
+					ShotHit->Damage += MoodRules::ComputePelletDamage(DamagePerPellet, DamageMultiplier * Locational);
 				}
+				ShotHit->PelletCount++;
+				ShotHit->Locations.Add(Hit.Location);
+			}
+
+			if (ImpactEffects) {
+				ImpactEffects->PlayEffect(HitEffect, Hit.Location, FRotator::ZeroRotator);
+			}
+			else if (LegacyHitEffect) {
+				GetWorld()->SpawnActor(LegacyHitEffect, &Hit.Location, &FRotator::ZeroRotator);
 			}
 		}
 
-		if (HitEffect) {
-			GetWorld()->SpawnActor(HitEffect, &Hit.Location, &FRotator::ZeroRotator); 
+		if (Tracers) {
+			Tracers->AddTracer(TracerSystem, TraceStart, Hit.bBlockingHit ? Hit.Location : TraceEnds[i]);
+		}
+		OnTraceNative.Broadcast(TraceStart, TraceEnds[i]);
+		if (OnTrace.IsBound()) {
+			OnTrace.Broadcast(TraceStart, TraceEnds[i]);
 		}
 	}
-	
-	OnTrace.Broadcast(MuzzleOrigin, LineTraceEnd);
+
+	for (const auto& ShotHit : ShotHits) {
+		if (ShotHit.Health) {
+			ShotHit.Health->Hurt(ShotHit.Damage, GetAttachmentRootActor());
+			if (DebugBullet) {
+				UE_LOG(LogTemp, Log, TEXT("Shot %ls with %d pellets"), *ShotHit.Victim->GetActorNameOrLabel(),
+				       ShotHit.PelletCount);
+			}
+		}
+		OnShotHitNative.Broadcast(ShotHit);
+	}
 }
 
 bool UMoodWeaponComponent::Use(FVector MuzzleOrigin, FVector MuzzleDirection, float DamageMultiplier) {
-	if (!UnlimitedAmmo && CurrentAmmo < 1) {
+	if (!HasAmmo()) {
 		return false;
 	}
 	
-	if (bIsInSlowMotion ? TimeSinceLastUse < SlowMotionFireRate : TimeSinceLastUse < FireDelay) {
+	const auto Now = GetWorld()->GetTimeSeconds();
+	if (Now < NextShotTime) {
 		return false;
 	}
 
-	// Reset this now that we've fired the shot
-	TimeSinceLastUse = 0.0f;
+	// Start the cooldown now that we're firing the shot
+	NextShotTime = Now + GetFireDelay();
+	Fire(MuzzleOrigin, FRotationMatrix::MakeFromX(MuzzleDirection).ToQuat(), DamageMultiplier);
+	return true;
+}
+
+int32 UMoodWeaponComponent::UseHeld(const FTransform& PreviousMuzzle, const FTransform& Muzzle, float DeltaTime,
+                                    float DamageMultiplier) {
+	const auto Now = GetWorld()->GetTimeSeconds();
+	const auto FrameStart = Now - DeltaTime;
+	NextShotTime = MoodRules::GetFirstShotTime(NextShotTime, FrameStart, Now);
+
+	auto Shots = 0;
+	while (NextShotTime <= Now && HasAmmo()) {
+		// Aimed from where the muzzle was at the moment the shot was due
+		const auto Alpha = DeltaTime > 0.f ? static_cast<float>((NextShotTime - FrameStart) / DeltaTime) : 1.f;
+		const auto Origin = FMath::Lerp(PreviousMuzzle.GetLocation(), Muzzle.GetLocation(), Alpha);
+		const auto Rotation = FQuat::Slerp(PreviousMuzzle.GetRotation(), Muzzle.GetRotation(), Alpha);
+
+		const auto Delay = GetFireDelay();
+		NextShotTime += Delay;
+		Fire(Origin, Rotation, DamageMultiplier);
+		Shots++;
+
+		// Without a delay there is no rate to catch up to, it fires once per frame
+		if (Delay <= 0.f) {
+			break;
+		}
+	}
+
+	return Shots;
+}
+
+float UMoodWeaponComponent::GetFireDelay() const {
+	const auto* TimeDilation = GetWorld()->GetSubsystem<UMoodTimeDilationSubsystem>();
+	const auto bIsInSlowMotion = TimeDilation != nullptr && TimeDilation->IsSlowMotion();
+	const auto Multiplier = Attributes ? Attributes->GetValue(Ema_FireDelay) : 1.f;
+	return MoodRules::GetFireDelay(GetWeaponRules(), bIsInSlowMotion) * Multiplier;
+}
+
+template <typename TFirePolicy>
+void UMoodWeaponComponent::FireWith(const UMoodWeaponDefinition& Weapon, const FVector& MuzzleOrigin,
+                                    const FQuat& MuzzleRotation, float DamageMultiplier) {
+	TFirePolicy::Fire(*this, Weapon, SpreadStream, MuzzleOrigin, MuzzleRotation, DamageMultiplier);
+
+	if (auto* Telemetry = UMoodTelemetrySubsystem::Get(this)) {
+		Telemetry->RecordWeaponFired(this, GetAttachmentRootActor(), TFirePolicy::GetNumTraces(Weapon));
+	}
+}
+
+void UMoodWeaponComponent::Fire(const FVector& MuzzleOrigin, const FQuat& MuzzleRotation, float DamageMultiplier) {
+	const auto* Weapon = GetDefinition();
 	// Use up ammo
-	if (!UnlimitedAmmo) {
+	if (!Weapon->UnlimitedAmmo) {
 		CurrentAmmo--;
 	}
 	
-	UWorld* const World = GetWorld();
-	if (World != nullptr) {
-		for (auto i = 0; i < PelletsPerShot; i++) {
-			auto Spread = FVector(
-				FMath::FRandRange(-MaxSpread.X, MaxSpread.X),
-				0.0f,
-				FMath::FRandRange(-MaxSpread.Y, MaxSpread.Y)
-			);
-
-			TraceHit(World, MuzzleOrigin, MuzzleDirection + Spread, DamageMultiplier);
+	if (GetWorld() != nullptr) {
+		switch (Weapon->FireMode) {
+		case Emf_Projectile:
+			FireWith<FProjectileFirePolicy>(*Weapon, MuzzleOrigin, MuzzleRotation, DamageMultiplier);
+			break;
+		case Emf_Melee:
+			FireWith<FMeleeFirePolicy>(*Weapon, MuzzleOrigin, MuzzleRotation, DamageMultiplier);
+			break;
+		default:
+			FireWith<FHitscanFirePolicy>(*Weapon, MuzzleOrigin, MuzzleRotation, DamageMultiplier);
+			break;
 		}
 	}
 
-	// Try and play the sound if specified
-	if (FireSound != nullptr) {
+	// Try and play the sound if specified and loaded
+	if (auto* FireSound = Weapon->FireSound.Get()) {
 		UGameplayStatics::PlaySoundAtLocation(this, FireSound, MuzzleOrigin);
 	}
-	
-	return true;
+}
+
+void UMoodWeaponComponent::OnRegister() {
+	Super::OnRegister();
+
+	BuildLegacyDefinition();
+}
+
+void UMoodWeaponComponent::BuildLegacyDefinition() {
+	if (Definition != nullptr || LegacyDefinition != nullptr) {
+		return;
+	}
+
+	if (GetWorld() && GetWorld()->IsGameWorld()) {
+		UE_LOG(LogTemp, Warning, TEXT("%s has no weapon definition, using its deprecated weapon properties"), *GetPathName());
+	}
+	LegacyDefinition = NewObject<UMoodWeaponDefinition>(this, TEXT("LegacyDefinition"), RF_Transient);
+	LegacyDefinition->FireDelay = FireDelay_DEPRECATED;
+	LegacyDefinition->SlowMotionFireRate = SlowMotionFireRate_DEPRECATED;
+	LegacyDefinition->Range = Range_DEPRECATED;
+	LegacyDefinition->PelletsPerShot = PelletsPerShot_DEPRECATED;
+	LegacyDefinition->DamagePerPellet = DamagePerPellet_DEPRECATED;
+	LegacyDefinition->MaxSpread = MaxSpread_DEPRECATED;
+	LegacyDefinition->UnlimitedAmmo = UnlimitedAmmo_DEPRECATED;
+	LegacyDefinition->MaxAmmo = MaxAmmo_DEPRECATED;
+	LegacyDefinition->StartAmmo = StartAmmo_DEPRECATED;
+	LegacyDefinition->AnimationID = AnimationID_DEPRECATED;
+	// Hard references, so these are loaded along with the component
+	LegacyDefinition->FireSound = FireSound_DEPRECATED;
+	LegacyDefinition->RecoilCameraShake = TSoftClassPtr<UCameraShakeBase>(RecoilCameraShake_DEPRECATED.Get());
+	LegacyDefinition->AmmoIcon = AmmoIcon_DEPRECATED;
+	LegacyDefinition->CrossHair = CrossHair_DEPRECATED;
 }
 
 void UMoodWeaponComponent::BeginPlay() {
 	Super::BeginPlay();
 
-	TimeSinceLastUse = FireDelay;
-	CurrentAmmo = StartAmmo;
+	CurrentAmmo = GetDefinition()->StartAmmo;
+	// Only an animated weapon mesh has anything to do in its tick
+	if (GetAnimInstance() == nullptr) {
+		SetComponentTickEnabled(false);
+	}
+	SpreadStream = UMoodDeterminismSubsystem::MakeStream(this, TEXT("WeaponSpread"));
+}
+
+const UMoodWeaponDefinition* UMoodWeaponComponent::GetDefinition() const {
+	if (Definition != nullptr) {
+		return Definition;
+	}
+	return LegacyDefinition != nullptr ? LegacyDefinition.Get() : GetDefault<UMoodWeaponDefinition>();
+}
+
+void UMoodWeaponComponent::LoadAssets(bool bForPlayer) {
+	if (Definition == nullptr) {
+		return;
+	}
+
+	TArray<FName> Bundles = {UMoodWeaponDefinition::EffectsBundle};
+	if (bForPlayer) {
+		Bundles.Add(UMoodWeaponDefinition::PlayerBundle);
+	}
+	AssetsHandle = UAssetManager::Get().LoadPrimaryAsset(Definition->GetPrimaryAssetId(), Bundles);
+}
+
+float UMoodWeaponComponent::GetRange() {
+	return GetDefinition()->Range;
 }
 
-void UMoodWeaponComponent::TickComponent(float DeltaTime, ELevelTick TickType,
-                                         FActorComponentTickFunction* ThisTickFunction) {
-	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+UTexture2D* UMoodWeaponComponent::GetAmmoIcon() {
+	return GetDefinition()->AmmoIcon.Get();
+}
+
+UTexture2D* UMoodWeaponComponent::GetCrossHair() {
+	return GetDefinition()->CrossHair.Get();
+}
+
+bool UMoodWeaponComponent::HasUnlimitedAmmo() {
+	return GetDefinition()->UnlimitedAmmo;
+}
+
+bool UMoodWeaponComponent::HasAmmo() const {
+	return GetDefinition()->UnlimitedAmmo || CurrentAmmo > 0;
+}
+
+FString UMoodWeaponComponent::GetAnimationID() {
+	return GetDefinition()->AnimationID;
+}
+
+TSubclassOf<UCameraShakeBase> UMoodWeaponComponent::GetRecoilCameraShake() {
+	return GetDefinition()->RecoilCameraShake.Get();
+}
 
-	TimeSinceLastUse += DeltaTime;
+MoodRules::FWeaponRules UMoodWeaponComponent::GetWeaponRules() const {
+	return GetDefinition()->GetWeaponRules();
 }
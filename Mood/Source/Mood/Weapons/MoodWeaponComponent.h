@@ -3,13 +3,32 @@
 #pragma once
 
 #include "Components/SkeletalMeshComponent.h"
+#include "Mood/Simulation/MoodRules.h"
 #include "MoodWeaponComponent.generated.h"
 
 class ULegacyCameraShake;
 class AMoodCharacter;
 class UTexture2D;
+class USoundBase;
+class UMoodHealthComponent;
+class UMoodHitboxComponent;
+class UMoodWeaponDefinition;
+class UMoodAttributeComponent;
+struct FStreamableHandle;
+
+// Every pellet of one shot that hit the same actor, applied to it as a single hit
+struct FMoodShotHit {
+    AActor* Victim = nullptr;
+    UMoodHealthComponent* Health = nullptr;
+    UMoodHitboxComponent* Hitboxes = nullptr;
+    int32 Damage = 0;
+    int32 PelletCount = 0;
+    TArray<FVector, TInlineAllocator<8>> Locations;
+};
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnTrace, FVector, TraceStart, FVector, TraceEnd);
+DECLARE_MULTICAST_DELEGATE_TwoParams(FOnTraceNative, const FVector& /*TraceStart*/, const FVector& /*TraceEnd*/);
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnShotHitNative, const FMoodShotHit& /*ShotHit*/);
 
 UCLASS(Blueprintable, BlueprintType, ClassGroup=(Custom), meta=(BlueprintSpawnableComponent))
 class UMoodWeaponComponent : public USkeletalMeshComponent {
@@ -18,84 +37,125 @@ class UMoodWeaponComponent : public USkeletalMeshComponent {
 public:    
     /** Sets default values for this component's properties */
     UMoodWeaponComponent();
+
+    // A new weapon registered on the owner, ready to be added to its weapon slot
+    static UMoodWeaponComponent* Create(AActor* Owner, const UMoodWeaponDefinition* InDefinition);
+    // Same, but a copy of the template, for weapons that only exist as a pickup's component
+    static UMoodWeaponComponent* CreateFromTemplate(AActor* Owner, UMoodWeaponComponent* Template);
     
+    // Weapons with a TracerSystem in their definition are drawn by UMoodTracerSubsystem, no need to spawn effects here
     UPROPERTY(BlueprintAssignable)
     FOnTrace OnTrace;
+    // Fires once per pellet, C++ listeners bind here and OnTrace is only broadcast when Blueprints listen
+    FOnTraceNative OnTraceNative;
+    // Fires once per actor hit by a shot, after its health component, if it has one, has been hurt
+    FOnShotHitNative OnShotHitNative;
 
     /** Make the weapon Fire a Projectile */
     UFUNCTION(BlueprintCallable)
     bool Use(FVector MuzzleOrigin, FVector MuzzleDirection, float DamageMultiplier);
+    /**
+     * Fires every shot the weapon owes for the frame while the trigger is held, so the fire rate doesn't
+     * depend on the frame rate. Each shot is aimed from the muzzle interpolated to the moment it was due.
+     * Returns the number of shots fired.
+     */
+    int32 UseHeld(const FTransform& PreviousMuzzle, const FTransform& Muzzle, float DeltaTime, float DamageMultiplier);
     UFUNCTION(BlueprintCallable)
     bool TryAddAmmo(int Amount);
 
     UFUNCTION(BlueprintCallable, BlueprintPure)
-    float GetRange() { return Range; }
+    float GetRange();
     UFUNCTION(BlueprintCallable, BlueprintPure)
     int GetCurrentAmmo() { return CurrentAmmo; }
+    // Cosmetics are null until LoadAssets has loaded the player bundle
     UFUNCTION(BlueprintCallable, BlueprintPure)
-    UTexture2D* GetAmmoIcon() { return AmmoIcon; }
+    UTexture2D* GetAmmoIcon();
     UFUNCTION(BlueprintCallable, BlueprintPure)
-    UTexture2D* GetCrossHair() { return CrossHair; }
+    UTexture2D* GetCrossHair();
     UFUNCTION(BlueprintCallable, BlueprintPure)
-    bool HasUnlimitedAmmo() { return UnlimitedAmmo; }
+    bool HasUnlimitedAmmo();
+    bool HasAmmo() const;
     UFUNCTION(BlueprintCallable, BlueprintPure)
-    FString GetAnimationID() { return AnimationID; }
+    FString GetAnimationID();
     UFUNCTION(BlueprintCallable, BlueprintPure)
-    TSubclassOf<UCameraShakeBase> GetRecoilCameraShake() { return RecoilCameraShake; }
+    TSubclassOf<UCameraShakeBase> GetRecoilCameraShake();
 
-    void SetSlowMotion(bool Value)
-    {
-        bIsInSlowMotion = Value;
-        UE_LOG(LogTemp, Log, TEXT("Slowmotion: %hhd"), Value);
-    }
-    
-protected:
-    virtual void TraceHit(UWorld* World, FVector MuzzleOrigin, FVector MuzzleDirection, float DamageMultiplier);
+    // The assigned definition, one built from the deprecated properties while there is none, or the
+    // defaults of the definition class for weapons that aren't registered
+    const UMoodWeaponDefinition* GetDefinition() const;
+    bool HasDefinition() const { return Definition != nullptr; }
+    MoodRules::FWeaponRules GetWeaponRules() const;
+    // Starts loading the definition's cosmetics, the player also gets the bundle with HUD textures and camera shakes
+    void LoadAssets(bool bForPlayer);
+    // The fire delay attribute of whoever holds the weapon, read every shot
+    void SetAttributes(const UMoodAttributeComponent* InAttributes) { Attributes = InAttributes; }
+
+    // Called by the hitscan subsystem with the pellet traces of a shot requested in Use
+    virtual void ResolveShot(const FVector& TraceStart, TConstArrayView<FVector> TraceEnds, TConstArrayView<FHitResult> Hits,
+                             float DamageMultiplier);
     
 private:
+    virtual void OnRegister() override;
     virtual void BeginPlay() override;
-    virtual void TickComponent(float DeltaTime, ELevelTick TickType,
-                               FActorComponentTickFunction* ThisTickFunction) override;
+
+    float GetFireDelay() const;
+    void Fire(const FVector& MuzzleOrigin, const FQuat& MuzzleRotation, float DamageMultiplier);
+    // Everything that differs between fire modes is in the policy, so each mode gets its own shot code
+    template <typename TFirePolicy>
+    void FireWith(const UMoodWeaponDefinition& Weapon, const FVector& MuzzleOrigin, const FQuat& MuzzleRotation,
+                  float DamageMultiplier);
     
     UPROPERTY(EditAnywhere, Category=Debug)
     bool DebugBullet = false;
 
-    //todo! MOVE ALL THIS TO A DATA CLASS    
-    UPROPERTY(EditDefaultsOnly, Category=Effects)
-    USoundBase* FireSound = nullptr;
-    UPROPERTY(EditDefaultsOnly, Category=Effects)
-    FString AnimationID = "Weapon";
-    UPROPERTY(EditDefaultsOnly, Category=Effects)
-    TSubclassOf<UCameraShakeBase> RecoilCameraShake = nullptr;
-    UPROPERTY(EditDefaultsOnly, Category=Effects)
-    TSubclassOf<AActor> HitEffect = nullptr;
-    
+    // Shared by every weapon of this kind, the component only keeps the state of this one weapon
     UPROPERTY(EditDefaultsOnly, Category=Weapon)
-    float FireDelay = 0.25f;
-    float TimeSinceLastUse = 0;
-    UPROPERTY(EditDefaultsOnly, Category=Weapon)
-    float SlowMotionFireRate = 0.1f;
-    bool bIsInSlowMotion = false;
-    
-    UPROPERTY(EditDefaultsOnly, Category=Weapon)
-    float Range = 10000.0f;
-    UPROPERTY(EditDefaultsOnly, Category=Weapon)
-    int PelletsPerShot = 5;
-    UPROPERTY(EditDefaultsOnly, Category=Weapon)
-    int DamagePerPellet = 5;
-    UPROPERTY(EditDefaultsOnly, Category=Weapon)
-    FVector2f MaxSpread = {0, 0};
+    TObjectPtr<const UMoodWeaponDefinition> Definition = nullptr;
+    UPROPERTY(Transient)
+    TObjectPtr<UMoodWeaponDefinition> LegacyDefinition = nullptr;
+    void BuildLegacyDefinition();
 
-    UPROPERTY(EditDefaultsOnly, Category=Weapon)
-    bool UnlimitedAmmo = false;
-    UPROPERTY(EditDefaultsOnly, Category=Weapon)
-    int MaxAmmo = 100;
-    UPROPERTY(EditDefaultsOnly, Category=Weapon)
-    int StartAmmo = 25;
+    // Authored on the component before weapon definitions existed, used while Definition is null.
+    // Move them to a definition asset, they are not saved again
+    UPROPERTY()
+    USoundBase* FireSound_DEPRECATED = nullptr;
+    UPROPERTY()
+    FString AnimationID_DEPRECATED = "Weapon";
+    UPROPERTY()
+    TSubclassOf<UCameraShakeBase> RecoilCameraShake_DEPRECATED = nullptr;
+    // An actor spawned for every hit, definitions play pooled Niagara systems instead
+    UPROPERTY()
+    TSubclassOf<AActor> HitEffect_DEPRECATED = nullptr;
+    UPROPERTY()
+    float FireDelay_DEPRECATED = 0.25f;
+    UPROPERTY()
+    float SlowMotionFireRate_DEPRECATED = 0.1f;
+    UPROPERTY()
+    float Range_DEPRECATED = 10000.0f;
+    UPROPERTY()
+    int PelletsPerShot_DEPRECATED = 5;
+    UPROPERTY()
+    int DamagePerPellet_DEPRECATED = 5;
+    UPROPERTY()
+    FVector2f MaxSpread_DEPRECATED = {0, 0};
+    UPROPERTY()
+    bool UnlimitedAmmo_DEPRECATED = false;
+    UPROPERTY()
+    int MaxAmmo_DEPRECATED = 100;
+    UPROPERTY()
+    int StartAmmo_DEPRECATED = 25;
+    UPROPERTY()
+    UTexture2D* AmmoIcon_DEPRECATED = nullptr;
+    UPROPERTY()
+    UTexture2D* CrossHair_DEPRECATED = nullptr;
+    UPROPERTY()
+    TObjectPtr<const UMoodAttributeComponent> Attributes = nullptr;
+
+    // World time the weapon can fire again, the weapon doesn't tick to count down its cooldown
+    double NextShotTime = 0.0;
+    FRandomStream SpreadStream;
     int CurrentAmmo = 0;
 
-    UPROPERTY(EditDefaultsOnly, Category=UI)
-    UTexture2D* AmmoIcon = nullptr;
-    UPROPERTY(EditDefaultsOnly, Category=UI)
-    UTexture2D* CrossHair = nullptr;
+    // Keeps the loaded bundles in memory for as long as the weapon exists
+    TSharedPtr<FStreamableHandle> AssetsHandle;
 };
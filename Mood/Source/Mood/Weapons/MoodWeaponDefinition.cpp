@@ -0,0 +1,54 @@
+#include "MoodWeaponDefinition.h"
+
+const FPrimaryAssetType UMoodWeaponDefinition::PrimaryAssetType = TEXT("MoodWeapon");
+const FName UMoodWeaponDefinition::EffectsBundle = TEXT("Effects");
+const FName UMoodWeaponDefinition::PlayerBundle = TEXT("Player");
+
+FPrimaryAssetId UMoodWeaponDefinition::GetPrimaryAssetId() const {
+	return FPrimaryAssetId(PrimaryAssetType, GetFName());
+}
+
+#if WITH_EDITOR
+void UMoodWeaponDefinition::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) {
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	bHasSpreadTable = false;
+}
+#endif
+
+MoodRules::FWeaponRules UMoodWeaponDefinition::GetWeaponRules() const {
+	MoodRules::FWeaponRules Rules;
+	Rules.FireDelay = FireDelay;
+	Rules.SlowMotionFireRate = SlowMotionFireRate;
+	Rules.Range = Range;
+	Rules.PelletsPerShot = PelletsPerShot;
+	Rules.DamagePerPellet = DamagePerPellet;
+	Rules.MaxSpread = MaxSpread;
+	Rules.GeneratedSpreadPatterns = GeneratedSpreadPatterns;
+	return Rules;
+}
+
+TArray<FVector2f> UMoodWeaponDefinition::GetSpreadPatternPellets(int32 Pellets) const {
+	TArray<FVector2f> Result;
+	for (const auto& Pattern : SpreadPatterns) {
+		if (Pattern.Pellets.Num() == Pellets) {
+			Result.Append(Pattern.Pellets);
+		}
+		else {
+			UE_LOG(LogTemp, Warning, TEXT("%s: Skipping a spread pattern with %d pellets, the weapon fires %d"),
+				*GetPathName(), Pattern.Pellets.Num(), Pellets);
+		}
+	}
+	return Result;
+}
+
+const MoodRules::FSpreadTable& UMoodWeaponDefinition::GetSpreadTable() const {
+	check(IsInGameThread());
+	if (!bHasSpreadTable) {
+		// Seeded from the asset, so the generated patterns are the same every session
+		const FRandomStream Stream(static_cast<int32>(FCrc::StrCrc32(*GetPathName())));
+		SpreadTable = MoodRules::BuildSpreadTable(GetSpreadPatternPellets(PelletsPerShot), GetWeaponRules(), Stream);
+		bHasSpreadTable = true;
+	}
+	return SpreadTable;
+}
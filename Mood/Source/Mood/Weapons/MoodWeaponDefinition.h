@@ -0,0 +1,132 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "Mood/Simulation/MoodRules.h"
+#include "MoodWeaponDefinition.generated.h"
+
+class UAnimInstance;
+class UCameraShakeBase;
+class UNiagaraSystem;
+class USkeletalMesh;
+class UStaticMesh;
+class USoundBase;
+class UTexture2D;
+
+USTRUCT(BlueprintType)
+struct FMoodSpreadPattern {
+	GENERATED_BODY()
+
+	// Pellet offsets along the muzzle's right and up axes, from -1 to 1 of the weapon's max spread
+	UPROPERTY(EditAnywhere)
+	TArray<FVector2f> Pellets;
+};
+
+UENUM(BlueprintType)
+enum EMoodFireMode
+{
+	Emf_Hitscan,
+	Emf_Projectile,
+	Emf_Melee
+};
+
+/**
+ * Everything about a kind of weapon, shared by every weapon component using it. Cosmetic assets are
+ * soft references in asset bundles: Effects is loaded for anyone carrying the weapon, Player only for
+ * the player, so enemy weapons never load HUD textures or camera shakes.
+ */
+UCLASS(BlueprintType)
+class UMoodWeaponDefinition : public UPrimaryDataAsset {
+	GENERATED_BODY()
+
+public:
+	static const FPrimaryAssetType PrimaryAssetType;
+	static const FName EffectsBundle;
+	static const FName PlayerBundle;
+
+	virtual FPrimaryAssetId GetPrimaryAssetId() const override;
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
+	MoodRules::FWeaponRules GetWeaponRules() const;
+	// Authored patterns back to back, leaving out any that don't have this many pellets
+	TArray<FVector2f> GetSpreadPatternPellets(int32 Pellets) const;
+	// Built on first use and shared by every weapon with this definition
+	const MoodRules::FSpreadTable& GetSpreadTable() const;
+
+	UPROPERTY(EditDefaultsOnly, Category=Weapon)
+	float FireDelay = 0.25f;
+	UPROPERTY(EditDefaultsOnly, Category=Weapon)
+	float SlowMotionFireRate = 0.1f;
+	UPROPERTY(EditDefaultsOnly, Category=Weapon)
+	float Range = 10000.0f;
+	UPROPERTY(EditDefaultsOnly, Category=Weapon)
+	int PelletsPerShot = 5;
+	UPROPERTY(EditDefaultsOnly, Category=Weapon)
+	int DamagePerPellet = 5;
+	UPROPERTY(EditDefaultsOnly, Category=Weapon)
+	FVector2f MaxSpread = {0, 0};
+	// Each shot uses one of these at random. Without any, GeneratedSpreadPatterns evenly spread ones are made
+	UPROPERTY(EditDefaultsOnly, Category=Weapon)
+	TArray<FMoodSpreadPattern> SpreadPatterns;
+	UPROPERTY(EditDefaultsOnly, Category=Weapon)
+	int32 GeneratedSpreadPatterns = 16;
+	// Projectiles are launched along the spread pattern's pellets and simulated by UMoodProjectileSubsystem
+	UPROPERTY(EditDefaultsOnly, Category=Weapon)
+	TEnumAsByte<EMoodFireMode> FireMode = Emf_Hitscan;
+	// A swing is one sphere sweep out to Range, dealing the damage of every pellet
+	UPROPERTY(EditDefaultsOnly, Category=Melee, meta=(EditCondition="FireMode==Emf_Melee"))
+	float MeleeRadius = 30.f;
+
+	UPROPERTY(EditDefaultsOnly, Category=Projectile, meta=(EditCondition="FireMode==Emf_Projectile"))
+	float ProjectileSpeed = 3000.f;
+	UPROPERTY(EditDefaultsOnly, Category=Projectile, meta=(EditCondition="FireMode==Emf_Projectile"))
+	float ProjectileRadius = 5.f;
+	UPROPERTY(EditDefaultsOnly, Category=Projectile, meta=(EditCondition="FireMode==Emf_Projectile"))
+	float ProjectileGravityScale = 0.f;
+	UPROPERTY(EditDefaultsOnly, Category=Projectile, meta=(EditCondition="FireMode==Emf_Projectile"))
+	int32 ProjectileMaxBounces = 0;
+	// Speed kept after a bounce
+	UPROPERTY(EditDefaultsOnly, Category=Projectile, meta=(EditCondition="FireMode==Emf_Projectile"))
+	float ProjectileBounciness = 0.6f;
+	UPROPERTY(EditDefaultsOnly, Category=Projectile, meta=(EditCondition="FireMode==Emf_Projectile"))
+	float ProjectileLifetime = 3.f;
+	UPROPERTY(EditDefaultsOnly, Category=Projectile, meta=(EditCondition="FireMode==Emf_Projectile", AssetBundles="Effects"))
+	TSoftObjectPtr<UStaticMesh> ProjectileMesh;
+
+	// What weapons created straight from the definition look like, picked up weapons use their pickup's mesh
+	UPROPERTY(EditDefaultsOnly, Category=Mesh)
+	TObjectPtr<USkeletalMesh> Mesh = nullptr;
+	UPROPERTY(EditDefaultsOnly, Category=Mesh)
+	TSubclassOf<UAnimInstance> AnimClass = nullptr;
+
+	UPROPERTY(EditDefaultsOnly, Category=Ammo)
+	bool UnlimitedAmmo = false;
+	UPROPERTY(EditDefaultsOnly, Category=Ammo)
+	int MaxAmmo = 100;
+	UPROPERTY(EditDefaultsOnly, Category=Ammo)
+	int StartAmmo = 25;
+
+	UPROPERTY(EditDefaultsOnly, Category=Effects)
+	FString AnimationID = "Weapon";
+	UPROPERTY(EditDefaultsOnly, Category=Effects, meta=(AssetBundles="Effects"))
+	TSoftObjectPtr<USoundBase> FireSound;
+	// Spawned from Niagara's component pool, the pool size is set on the system
+	UPROPERTY(EditDefaultsOnly, Category=Effects, meta=(AssetBundles="Effects"))
+	TSoftObjectPtr<UNiagaraSystem> HitEffect;
+	// Drawn for every pellet by the tracer subsystem, one system for all weapons sharing it
+	UPROPERTY(EditDefaultsOnly, Category=Effects, meta=(AssetBundles="Effects"))
+	TSoftObjectPtr<UNiagaraSystem> TracerSystem;
+	UPROPERTY(EditDefaultsOnly, Category=Effects, meta=(AssetBundles="Player"))
+	TSoftClassPtr<UCameraShakeBase> RecoilCameraShake;
+
+	UPROPERTY(EditDefaultsOnly, Category=UI, meta=(AssetBundles="Player"))
+	TSoftObjectPtr<UTexture2D> AmmoIcon;
+	UPROPERTY(EditDefaultsOnly, Category=UI, meta=(AssetBundles="Player"))
+	TSoftObjectPtr<UTexture2D> CrossHair;
+
+private:
+	mutable MoodRules::FSpreadTable SpreadTable;
+	mutable bool bHasSpreadTable = false;
+};
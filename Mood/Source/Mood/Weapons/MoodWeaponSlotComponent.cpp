@@ -3,13 +3,28 @@
 #include "MoodWeaponPickup.h"
 #include "GameFramework/Character.h"
 #include "Kismet/GameplayStatics.h"
+#include "Mood/MoodAttributeComponent.h"
 #include "Mood/MoodPickUpComponent.h"
+#include "Mood/Player/MoodCharacter.h"
+#include "Mood/Telemetry/MoodTelemetrySubsystem.h"
 
 UMoodWeaponSlotComponent::UMoodWeaponSlotComponent() {
 	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
 	UMoodWeaponSlotComponent::SetAutoActivate(true);
 }
 
+void UMoodWeaponSlotComponent::SetTriggerHeld(bool InTriggerHeld) {
+	// Input can report a held trigger every frame, only pressing or releasing it starts a new muzzle history
+	if (InTriggerHeld == TriggerHeld) {
+		return;
+	}
+
+	TriggerHeld = InTriggerHeld;
+	bHasPreviousMuzzle = false;
+	SetComponentTickEnabled(TriggerHeld);
+}
+
 bool UMoodWeaponSlotComponent::AddWeapon(UMoodWeaponComponent* Weapon) {
 	if (!Owner || !Weapon) {
 		return false;
@@ -20,6 +35,9 @@ bool UMoodWeaponSlotComponent::AddWeapon(UMoodWeaponComponent* Weapon) {
 	}
 
 	Weapons.Add(Weapon);
+	// Enemies only need what others see and hear, the player also needs the HUD and recoil assets
+	Weapon->LoadAssets(Owner->IsA<AMoodCharacter>());
+	Weapon->SetAttributes(Attributes);
 	
 	FAttachmentTransformRules AttachmentRules(
 		EAttachmentRule::SnapToTarget, EAttachmentRule::SnapToTarget,
@@ -56,7 +74,9 @@ void UMoodWeaponSlotComponent::EnableSelectedWeapon() {
 		Weapon->SetActive(WeaponActive);
 	}
 
-	UE_LOG(LogTemp, Log, TEXT("Selected %ls"), *Weapons[SelectedWeaponIndex]->GetAnimationID());
+	if (auto* Telemetry = UMoodTelemetrySubsystem::Get(this)) {
+		Telemetry->RecordWeaponSelected(Weapons[SelectedWeaponIndex], GetOwner());
+	}
 }
 
 void UMoodWeaponSlotComponent::SelectNextWeapon() {
@@ -88,7 +108,7 @@ UMoodWeaponComponent* UMoodWeaponSlotComponent::GetSelectedWeapon() {
 	return Weapons[SelectedWeaponIndex];
 }
 
-void UMoodWeaponSlotComponent::UseSelectedWeapon() {
+void UMoodWeaponSlotComponent::UseSelectedWeapon(float DeltaTime) {
 	// We dont have any weapons
 	if (Weapons.Num() == 0) {
 		return;
@@ -105,13 +125,27 @@ void UMoodWeaponSlotComponent::UseSelectedWeapon() {
 	}
 	
 	auto SelectedWeapon = Weapons[SelectedWeaponIndex];
-	auto MuzzleOrigin = MuzzleRoot ? MuzzleRoot->GetComponentLocation() : Owner->GetActorLocation();
-	auto MuzzleDirection = MuzzleRoot ? MuzzleRoot->GetForwardVector() : Owner->GetActorForwardVector();
-	auto WeaponUsedSuccess = SelectedWeapon->Use(MuzzleOrigin + MuzzleOffset, MuzzleDirection, DamageMultiplier);
-
-	if (WeaponUsedSuccess) {
-		OnWeaponUsed.Broadcast(SelectedWeapon);
+	auto Muzzle = GetMuzzleTransform();
+	if (!bHasPreviousMuzzle) {
+		PreviousMuzzle = Muzzle;
+		bHasPreviousMuzzle = true;
 	}
+	const auto Damage = Attributes ? Attributes->GetValue(Ema_Damage) : DamageMultiplier;
+	auto Shots = SelectedWeapon->UseHeld(PreviousMuzzle, Muzzle, DeltaTime, Damage);
+	PreviousMuzzle = Muzzle;
+
+	for (auto i = 0; i < Shots; i++) {
+		OnWeaponUsedNative.Broadcast(SelectedWeapon);
+		if (OnWeaponUsed.IsBound()) {
+			OnWeaponUsed.Broadcast(SelectedWeapon);
+		}
+	}
+}
+
+FTransform UMoodWeaponSlotComponent::GetMuzzleTransform() const {
+	auto MuzzleOrigin = MuzzleRoot ? MuzzleRoot->GetComponentLocation() : Owner->GetActorLocation();
+	auto MuzzleRotation = MuzzleRoot ? MuzzleRoot->GetComponentQuat() : Owner->GetActorQuat();
+	return FTransform(MuzzleRotation, MuzzleOrigin + MuzzleOffset);
 }
 
 bool UMoodWeaponSlotComponent::TryAddAmmo(int Amount) {
@@ -128,15 +162,52 @@ TArray<UMoodWeaponComponent*> UMoodWeaponSlotComponent::GetWeaponArray()
 	return Weapons;
 }
 
+void UMoodWeaponSlotComponent::PostLoad() {
+	Super::PostLoad();
+
+	DefaultWeapons_DEPRECATED.RemoveAll([](const TSubclassOf<AMoodWeaponPickup>& PickupClass) {
+		return PickupClass == nullptr;
+	});
+	DefaultWeapons_DEPRECATED.RemoveAll([this](const TSubclassOf<AMoodWeaponPickup>& PickupClass) {
+		const auto* Weapon = GetPickupWeapon(PickupClass);
+		if (!Weapon || !Weapon->HasDefinition()) {
+			return false;
+		}
+		DefaultWeaponDefinitions.AddUnique(Weapon->GetDefinition());
+		return true;
+	});
+}
+
+UMoodWeaponComponent* UMoodWeaponSlotComponent::GetPickupWeapon(TSubclassOf<AMoodWeaponPickup> PickupClass) {
+	auto* Pickup = PickupClass ? PickupClass->GetDefaultObject<AMoodWeaponPickup>() : nullptr;
+	if (!Pickup) {
+		return nullptr;
+	}
+	Pickup->ConditionalPostLoad();
+	return Pickup->GetWeapon();
+}
+
 void UMoodWeaponSlotComponent::BeginPlay() {
 	Super::BeginPlay();
 
 	Owner = Cast<ACharacter>(GetOwner());
+	Attributes = UMoodAttributeComponent::Get(Owner);
 
-	for (auto i = 0; i < DefaultWeapons.Num(); i++) {
-		auto WeaponPickup = GetWorld()->SpawnActor<AMoodWeaponPickup>(DefaultWeapons[i]);
-		AddWeapon(WeaponPickup->GetWeapon());
-		WeaponPickup->Disable();
+	for (const auto& Definition : DefaultWeaponDefinitions) {
+		if (!AddWeapon(UMoodWeaponComponent::Create(Owner, Definition))) {
+			UE_LOG(LogTemp, Error, TEXT("%s failed to create default weapon %s"),
+				*GetOwner()->GetActorNameOrLabel(), *GetNameSafe(Definition));
+		}
+	}
+	for (const auto& PickupClass : DefaultWeapons_DEPRECATED) {
+		if (!AddWeapon(UMoodWeaponComponent::CreateFromTemplate(Owner, GetPickupWeapon(PickupClass)))) {
+			UE_LOG(LogTemp, Error, TEXT("%s failed to create default weapon from pickup %s"),
+				*GetOwner()->GetActorNameOrLabel(), *GetNameSafe(PickupClass));
+		}
+	}
+	if (Weapons.Num() == 0) {
+		UE_LOG(LogTemp, Error, TEXT("%s has no weapons, check the default weapons of its slot"),
+			*GetOwner()->GetActorNameOrLabel());
 	}
 }
 
@@ -146,7 +217,7 @@ void UMoodWeaponSlotComponent::TickComponent(float DeltaTime, ELevelTick TickTyp
 	if (!HasWeapon()) { return;	}	
 	if (!TriggerHeld) { return;	}
 	
-	UseSelectedWeapon();
+	UseSelectedWeapon(DeltaTime);
 }
 
 
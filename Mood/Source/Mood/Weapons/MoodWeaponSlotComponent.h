@@ -4,10 +4,13 @@
 #include "MoodAmmoPickup.h"
 #include "MoodWeaponSlotComponent.generated.h"
 
-class AMoodWeaponPickup;
 class UMoodWeaponComponent;
+class UMoodWeaponDefinition;
+class UMoodAttributeComponent;
+class AMoodWeaponPickup;
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnWeaponUsed, UMoodWeaponComponent*, Weapon);
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnWeaponUsedNative, UMoodWeaponComponent* /*Weapon*/);
 
 UCLASS(Blueprintable, BlueprintType, ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
 class UMoodWeaponSlotComponent : public UActorComponent {
@@ -18,15 +21,15 @@ public:
 
 	UPROPERTY(BlueprintAssignable)
 	FOnWeaponUsed OnWeaponUsed;
+	// C++ listeners bind here, OnWeaponUsed is only broadcast when Blueprints listen
+	FOnWeaponUsedNative OnWeaponUsedNative;
 
 	UFUNCTION(BlueprintCallable)
 	bool AddWeapon(UMoodWeaponComponent* Weapon);
 
+	// For owners without attributes, the damage attribute is used when there is one
 	UFUNCTION(BlueprintCallable)
-	void SetDamageMultiplier(float InDamageMultiplier) {
-		if (InDamageMultiplier < 1.0f) { InDamageMultiplier = 1.0f; }
-		DamageMultiplier = InDamageMultiplier;
-	}
+	void SetDamageMultiplier(float InDamageMultiplier) { DamageMultiplier = FMath::Max(0.f, InDamageMultiplier); }
 	
 	UFUNCTION(BlueprintCallable, BlueprintPure)
 	bool HasWeapon() { return Weapons.Num() > 0; }
@@ -45,10 +48,9 @@ public:
 	UFUNCTION(BlueprintCallable)
 	void SetMuzzleRoot(USceneComponent* InMuzzleRoot) { MuzzleRoot = InMuzzleRoot; }
 	
+	// The slot only ticks while the trigger is held
 	UFUNCTION(BlueprintCallable)
-	void SetTriggerHeld(bool InTriggerHeld) {
-		TriggerHeld = InTriggerHeld;
-	}
+	void SetTriggerHeld(bool InTriggerHeld);
 
 	UFUNCTION(BlueprintCallable)
 	bool TryAddAmmo(int Amount);
@@ -60,22 +62,36 @@ public:
 	USoundBase* SelectWeaponSound;
 
 private:
+	virtual void PostLoad() override;
+	// The weapon component a pickup class is created with, null when it has none
+	static UMoodWeaponComponent* GetPickupWeapon(TSubclassOf<AMoodWeaponPickup> PickupClass);
 	virtual void BeginPlay() override;
 	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
 
+	// Created right on the owner, no pickup is spawned for them
 	UPROPERTY(EditDefaultsOnly)
-	TArray<TSubclassOf<AMoodWeaponPickup>> DefaultWeapons = {};
+	TArray<TObjectPtr<const UMoodWeaponDefinition>> DefaultWeaponDefinitions = {};
+	// Loadouts saved as pickup classes. Pickups whose weapon has a definition are moved over to it on load,
+	// the weapons of the others are copied from the pickup until they get one
+	UPROPERTY()
+	TArray<TSubclassOf<AMoodWeaponPickup>> DefaultWeapons_DEPRECATED;
 
 	void EnableSelectedWeapon();
-	void UseSelectedWeapon();
+	void UseSelectedWeapon(float DeltaTime);
+	FTransform GetMuzzleTransform() const;
 
 	UPROPERTY()
 	TObjectPtr<ACharacter> Owner = nullptr;
+	UPROPERTY()
+	TObjectPtr<const UMoodAttributeComponent> Attributes = nullptr;
 	UPROPERTY(EditDefaultsOnly)
 	TObjectPtr<USceneComponent> MuzzleRoot = nullptr;
 	
 	int SelectedWeaponIndex = 0;
 	bool TriggerHeld = false;
+	// Muzzle at the end of the previous tick, catch-up shots are aimed between it and the current one
+	FTransform PreviousMuzzle;
+	bool bHasPreviousMuzzle = false;
 	float DamageMultiplier = 1.0f;
 	
 	/** Gun muzzle's offset from the characters location */